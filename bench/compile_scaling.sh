@@ -0,0 +1,62 @@
+#!/bin/bash
+# Compile generated MiniC programs of increasing size to object files (mccomp -c)
+# and report compile time and peak RSS per size. The "growth" column is the
+# fitted exponent k in time ~ size^k between consecutive sizes; k well above 1
+# points at a quadratic (or worse) algorithm somewhere in the compiler.
+#
+# Usage: bench/compile_scaling.sh [sizes...]      (sizes = number of functions)
+# Environment:
+#   OPT=-O0|-O1|-O2|-O3   optimization level passed to mccomp (default -O0)
+#   MCCOMP_FLAGS          extra mccomp flags
+#   GEN_FLAGS             extra bench/gen_minic.sh flags (default "-s 20 -e 3 -n 2")
+set -e
+
+SIZES=${*:-"50 100 200 400 800 1600"}
+OPT=${OPT:--O0}
+GEN_FLAGS=${GEN_FLAGS:--s 20 -e 3 -n 2}
+
+DIR="$(cd "$(dirname "$0")/.." && pwd)"
+MCCOMP="$DIR/mccomp"
+CLANG=${CLANG:-clang++}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+if [ ! -x "$MCCOMP" ]; then
+    echo "mccomp not found - run make first"
+    exit 1
+fi
+
+"$CLANG" -O2 "$DIR/bench/runstat.cpp" -o "$WORK/runstat"
+
+echo "mccomp -c $OPT $MCCOMP_FLAGS, generator flags: $GEN_FLAGS"
+printf "%8s %9s %10s %12s %10s %8s\n" "funcs" "lines" "time (s)" "peak RSS MiB" "us/line" "growth"
+
+PREV_SIZE=
+PREV_TIME=
+for SIZE in $SIZES; do
+    SRC="$WORK/gen_$SIZE.c"
+    # shellcheck disable=SC2086
+    "$DIR/bench/gen_minic.sh" -f "$SIZE" $GEN_FLAGS > "$SRC"
+    LINES=$(wc -l < "$SRC")
+
+    # runstat appends "<seconds> <peak KiB> <exit code>" after mccomp's own stderr
+    # shellcheck disable=SC2086
+    (cd "$WORK" && ./runstat "$MCCOMP" "$SRC" -c $OPT $MCCOMP_FLAGS -o "$WORK/out.o" \
+         > /dev/null 2> "$WORK/mccomp.err") || true
+    STATS=$(tail -1 "$WORK/mccomp.err")
+    read -r SECS KIB CODE <<< "$STATS"
+    if [ "$CODE" != "0" ]; then
+        echo "mccomp failed on $SIZE functions (exit $CODE):"
+        grep -i error "$WORK/mccomp.err" | head -5
+        exit 1
+    fi
+
+    awk -v n="$SIZE" -v lines="$LINES" -v t="$SECS" -v kib="$KIB" \
+        -v pn="$PREV_SIZE" -v pt="$PREV_TIME" 'BEGIN {
+        growth = "-"
+        if (pn != "" && pt > 0 && t > 0) growth = sprintf("%.2f", log(t / pt) / log(n / pn))
+        printf "%8d %9d %10.3f %12.1f %10.2f %8s\n", n, lines, t, kib / 1024, t * 1e6 / lines, growth
+    }'
+    PREV_SIZE=$SIZE
+    PREV_TIME=$SECS
+done
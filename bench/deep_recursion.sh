@@ -0,0 +1,80 @@
+#!/bin/bash
+# Run linear recursions at depth 10^6 with and without tail-call / recursion-to-loop
+# conversion (-fno-optimize-sibling-calls) and report time or the crash.
+#
+# Usage: bench/deep_recursion.sh [depth] [opt level]
+set -e
+
+DEPTH=${1:-1000000}
+OPT=${2:--O0}
+
+DIR="$(cd "$(dirname "$0")/.." && pwd)"
+MCCOMP="$DIR/mccomp"
+CLANG=${CLANG:-clang++}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+if [ ! -x "$MCCOMP" ]; then
+    echo "mccomp not found - run make first"
+    exit 1
+fi
+
+cat > "$WORK/recursion.c" <<'SRC'
+// accumulator recursion: result = n + addNumbers(n - 1)
+int addNumbers(int n) {
+  int result;
+  result = 0;
+  if (n != 0) {
+    result = n + addNumbers(n - 1);
+  } else {
+    result = n;
+  }
+  return result;
+}
+
+// plain tail recursion
+int countdown(int n, int acc) {
+  if (n == 0) {
+    return acc;
+  }
+  return countdown(n - 1, acc + 1);
+}
+SRC
+
+cat > "$WORK/driver.cpp" <<'SRC'
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+extern "C" {
+    int addNumbers(int n);
+    int countdown(int n, int acc);
+}
+
+int main(int argc, char** argv) {
+    int depth = atoi(argv[1]);
+    auto start = std::chrono::steady_clock::now();
+    int sum = addNumbers(depth);
+    int count = countdown(depth, 0);
+    auto end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    printf("addNumbers=%d countdown=%d %.2f ms\n", sum, count, ms);
+    return count == depth ? 0 : 1;
+}
+SRC
+
+# run_variant <label> <mccomp flags...>
+run_variant() {
+    local label=$1
+    shift
+    (cd "$WORK" && "$MCCOMP" recursion.c "$OPT" "$@" -o "$label.ll" > /dev/null 2>&1)
+    "$CLANG" -O2 "$WORK/driver.cpp" "$WORK/$label.ll" -o "$WORK/$label"
+    printf "%-22s " "$label:"
+    if ! "$WORK/$label" "$DEPTH" 2> /dev/null; then
+        echo "crashed (stack overflow at depth $DEPTH)"
+    fi
+}
+
+echo "Depth $DEPTH, $OPT, stack limit $(ulimit -s)"
+run_variant "recursion-to-loop"
+run_variant "plain-calls" -fno-optimize-sibling-calls
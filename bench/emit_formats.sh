@@ -0,0 +1,75 @@
+#!/bin/bash
+# Compare textual IR (output.ll) with bitcode (-emit-llvm-bc) emission:
+# output size and wall-clock compile time on a large generated module.
+#
+# Usage: bench/emit_formats.sh [num_functions] [repetitions]
+set -e
+
+NUM_FUNCS=${1:-2000}
+REPS=${2:-5}
+
+DIR="$(cd "$(dirname "$0")/.." && pwd)"
+MCCOMP="$DIR/mccomp"
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+if [ ! -x "$MCCOMP" ]; then
+    echo "mccomp not found - run make first"
+    exit 1
+fi
+
+# Generate a module with NUM_FUNCS functions, each with a loop, a branch and a call
+SRC="$WORK/large.c"
+{
+    echo "int g;"
+    echo "float acc[64];"
+    echo "int f0(int n) { return n; }"
+    for ((i = 1; i < NUM_FUNCS; i++)); do
+        cat <<FUNC
+int f$i(int n) {
+  int i;
+  int s;
+  s = 0;
+  i = 0;
+  while (i < n) {
+    if (i % 3 == 0) { s = s + f$((i - 1))(i); } else { s = s - i * $i; }
+    acc[i % 64] = acc[i % 64] + 0.5;
+    i = i + 1;
+  }
+  g = g + s;
+  return s;
+}
+FUNC
+    done
+} > "$SRC"
+
+echo "Generated $NUM_FUNCS functions ($(wc -l < "$SRC") lines)"
+
+# time_compile <label> <output file> <mccomp args...>
+time_compile() {
+    local label=$1 out=$2
+    shift 2
+    local best=""
+    for ((r = 0; r < REPS; r++)); do
+        local start end ms
+        start=$(date +%s%N)
+        "$MCCOMP" "$SRC" "$@" -o "$out" > /dev/null 2>&1
+        end=$(date +%s%N)
+        ms=$(( (end - start) / 1000000 ))
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then best=$ms; fi
+    done
+    printf "%-14s %10d bytes %8d ms (best of %d)\n" "$label" "$(stat -c %s "$out")" "$best" "$REPS"
+}
+
+time_compile "textual IR" "$WORK/out.ll"
+time_compile "bitcode" "$WORK/out.bc" -emit-llvm-bc
+
+# Re-parse cost for downstream tools
+if command -v opt > /dev/null; then
+    for f in out.ll out.bc; do
+        start=$(date +%s%N)
+        opt -disable-output "$WORK/$f"
+        end=$(date +%s%N)
+        printf "%-14s re-parse by opt: %d ms\n" "$f" $(( (end - start) / 1000000 ))
+    done
+fi
@@ -0,0 +1,150 @@
+#!/bin/bash
+# Generate a synthetic (deterministic) MiniC program of a given size on stdout.
+#
+# Usage: bench/gen_minic.sh [options] > program.c
+#   -f N   number of functions                 (default 10)
+#   -s N   statements per function body        (default 20)
+#   -e N   expression depth                    (default 3)
+#   -n N   if/while nesting depth              (default 2)
+#   -a N   array dimensions, 0 for no arrays   (default 2)
+#   -g N   number of global variables/arrays   (default 4)
+#   -x N   number of extern declarations       (default 2)
+#   -r N   random seed                         (default 1)
+#
+# Every function only calls functions defined above it, so the output is a
+# valid compilation unit for mccomp (and also valid C).
+set -e
+
+FUNCS=10
+STMTS=20
+EXPR_DEPTH=3
+NEST_DEPTH=2
+ARRAY_DIMS=2
+GLOBALS=4
+EXTERNS=2
+SEED=1
+
+while getopts "f:s:e:n:a:g:x:r:h" opt; do
+    case $opt in
+        f) FUNCS=$OPTARG ;;
+        s) STMTS=$OPTARG ;;
+        e) EXPR_DEPTH=$OPTARG ;;
+        n) NEST_DEPTH=$OPTARG ;;
+        a) ARRAY_DIMS=$OPTARG ;;
+        g) GLOBALS=$OPTARG ;;
+        x) EXTERNS=$OPTARG ;;
+        r) SEED=$OPTARG ;;
+        *) sed -n '2,14p' "$0" | sed 's/^# \{0,1\}//'; exit 1 ;;
+    esac
+done
+
+awk -v funcs="$FUNCS" -v stmts="$STMTS" -v edepth="$EXPR_DEPTH" \
+    -v ndepth="$NEST_DEPTH" -v adims="$ARRAY_DIMS" -v nglobals="$GLOBALS" \
+    -v nexterns="$EXTERNS" -v seed="$SEED" '
+# pick - random integer in [0, n)
+function pick(n) { return int(rand() * n) }
+
+function indent(level,    s, i) {
+    s = ""
+    for (i = 0; i < level; i++) s = s "    "
+    return s
+}
+
+# subscript - one "[...]" per array dimension, always in bounds
+function subscript(    s, d) {
+    s = ""
+    for (d = 0; d < adims; d++) s = s "[" pick(4) "]"
+    return s
+}
+
+# leaf - an int-valued variable, global, array element or literal
+function leaf(    k) {
+    k = pick(6)
+    if (k == 0) return pick(100)
+    if (k == 1 && nglobals > 0) return "g" pick(nglobals)
+    if (k == 2 && adims > 0) return (nglobals > 0 && pick(2) ? "garr" : "arr") subscript()
+    if (k == 3) return "p" pick(2)
+    return "v" pick(4)
+}
+
+# expr - a random int expression of at most the given depth
+function expr(depth,    k, ops) {
+    if (depth <= 0) return leaf()
+    k = pick(8)
+    if (k == 0) return "-" leaf()
+    if (k == 1) return "(" expr(depth - 1) ")"
+    ops = "+-*+-*%/"
+    return expr(depth - 1) " " substr(ops, k + 1, 1) " " expr(depth - 1)
+}
+
+function cond(depth) {
+    if (pick(3) == 0)
+        return "(" expr(depth) " < " expr(depth) ") && (" expr(depth) " != 0)"
+    return expr(depth) " > " expr(depth)
+}
+
+# stmt - emit one statement (possibly a nested if/while block) at the given nesting level
+function stmt(fn, level, nest,    k, pad, i, callee) {
+    pad = indent(level)
+    k = pick(10)
+    if (k < 2 && nest > 0) {
+        print pad "if (" cond(edepth > 1 ? edepth - 1 : 1) ") {"
+        for (i = 0; i < 2; i++) stmt(fn, level + 1, nest - 1)
+        print pad "} else {"
+        stmt(fn, level + 1, nest - 1)
+        print pad "}"
+    } else if (k == 2 && nest > 0) {
+        i = pick(4)
+        print pad "v" i " = 0;"
+        print pad "while (v" i " < " (pick(8) + 1) ") {"
+        stmt(fn, level + 1, nest - 1)
+        print pad "    v" i " = v" i " + 1;"
+        print pad "}"
+    } else if (k == 3 && fn > 0) {
+        callee = pick(fn)
+        print pad "v" pick(4) " = f" callee "(" expr(1) ", " expr(1) ");"
+    } else if (k == 4 && nglobals > 0) {
+        i = pick(nglobals)
+        print pad "g" i " = g" i " + " expr(edepth) ";"
+    } else if (k == 5 && adims > 0) {
+        print pad "arr" subscript() " = " expr(edepth) ";"
+    } else if (k == 6 && nexterns > 0) {
+        print pad "ext" pick(nexterns) "(" expr(edepth) ");"
+    } else if (k == 7) {
+        print pad "w0 = w0 + " expr(edepth) ";"
+    } else {
+        print pad "v" pick(4) " = " expr(edepth) ";"
+    }
+}
+
+BEGIN {
+    srand(seed)
+    dims = ""
+    for (d = 0; d < adims; d++) dims = dims "[4]"
+
+    printf "// Generated by bench/gen_minic.sh -f %d -s %d -e %d -n %d -a %d -g %d -x %d -r %d\n",
+           funcs, stmts, edepth, ndepth, adims, nglobals, nexterns, seed
+    for (i = 0; i < nexterns; i++) print "extern int ext" i "(int x);"
+    for (i = 0; i < nglobals; i++) print "int g" i ";"
+    if (nglobals > 0 && adims > 0) print "int garr" dims ";"
+    print ""
+
+    for (fn = 0; fn < funcs; fn++) {
+        print "int f" fn "(int p0, int p1) {"
+        print "    int v0;"
+        print "    int v1;"
+        print "    int v2;"
+        print "    int v3;"
+        print "    float w0;"
+        if (adims > 0) print "    int arr" dims ";"
+        print "    v0 = p0;"
+        print "    v1 = p1;"
+        print "    v2 = 0;"
+        print "    v3 = 1;"
+        print "    w0 = 0.5;"
+        for (s = 0; s < stmts; s++) stmt(fn, 1, ndepth)
+        print "    return v0 + v1 + v2 + v3;"
+        print "}"
+        print ""
+    }
+}'
@@ -0,0 +1,79 @@
+#!/bin/bash
+# Stream over two large global float arrays with 32-bit and 64-bit array
+# subscripts (--index-width) and report the time per element, bandwidth and
+# whether the loop was vectorized. Arrays are N floats each, so N above
+# 536870912 makes them larger than 2 GiB.
+#
+# Usage: bench/index_width.sh [N] [opt level]
+#   N        elements per array (default 33554432, 128 MiB per array)
+#   RUNS=5   timed runs per variant; the fastest is reported
+set -e
+
+N=${1:-33554432}
+OPT=${2:--O2}
+RUNS=${RUNS:-5}
+
+DIR="$(cd "$(dirname "$0")/.." && pwd)"
+MCCOMP="$DIR/mccomp"
+CLANG=${CLANG:-clang++}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+if [ ! -x "$MCCOMP" ]; then
+    echo "mccomp not found - run make first"
+    exit 1
+fi
+
+# y[i] += s * x[i + 1]: the offset subscript is where 32-bit indices need a
+# sign extension after the add
+cat > "$WORK/stream.c" <<SRC
+float x[$((N + 1))];
+float y[$N];
+
+float stream(float s, int n) {
+  int i;
+  i = 0;
+  while (i < n) {
+    y[i] = y[i] + s * x[i + 1];
+    i = i + 1;
+  }
+  return y[n - 1];
+}
+SRC
+
+cat > "$WORK/driver.cpp" <<'SRC'
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+extern "C" float stream(float s, int n);
+extern "C" float x[];
+extern "C" float y[];
+
+int main(int argc, char** argv) {
+    int n = atoi(argv[1]);
+    int runs = atoi(argv[2]);
+    for (int i = 0; i <= n; i++) x[i] = (float)(i & 1023);
+    stream(0.0f, n); // fault in y
+
+    double best = 0;
+    for (int r = 0; r < runs; r++) {
+        auto start = std::chrono::steady_clock::now();
+        stream(0.5f, n);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (r == 0 || secs < best) best = secs;
+    }
+    // Reads x and y, writes y
+    printf("%10.3f %10.2f\n", best * 1e9 / n, 12.0 * n / best / 1e9);
+    return 0;
+}
+SRC
+
+echo "N=$N ($(( N * 4 / 1048576 )) MiB per array), $OPT, best of $RUNS"
+printf "%-12s %10s %10s %11s\n" "index" "ns/elem" "GB/s" "vectorized"
+for WIDTH in 32 64; do
+    (cd "$WORK" && "$MCCOMP" stream.c "$OPT" --index-width=$WIDTH -o "stream$WIDTH.ll" > /dev/null 2>&1)
+    "$CLANG" -O2 "$WORK/driver.cpp" "$WORK/stream$WIDTH.ll" -o "$WORK/stream$WIDTH"
+    VECTORIZED=$(grep -q "x float>" "$WORK/stream$WIDTH.ll" && echo yes || echo no)
+    printf "%-12s %s %11s\n" "i$WIDTH" "$("$WORK/stream$WIDTH" "$N" "$RUNS")" "$VECTORIZED"
+done
@@ -0,0 +1,114 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "perf_counters.h"
+
+// Timing harness for the MiniC kernels in tests/*, used by bench/runtime_vs_clang.sh.
+// Exactly one KERNEL_* macro selects the kernel to link against:
+//
+//   clang++ -O2 -DKERNEL_PI kernel_driver.cpp pi.ll -o bench_pi
+//
+// Prints "<ns per call> <checksum>"; the checksum comes from one untimed
+// call so results of different compilers can be compared. With BENCH_COUNTERS=1
+// in the environment a second line reports hardware counters per call.
+
+#ifndef MATRIX_N
+#define MATRIX_N 10
+#endif
+
+#ifndef FIB_N
+#define FIB_N 40
+#endif
+
+static volatile long PrintCalls = 0;
+
+// The kernels' print_* calls are part of the measured work but not the output
+extern "C" int print_int(int X) {
+    PrintCalls = PrintCalls + 1;
+    return 0;
+}
+
+extern "C" float print_float(float X) {
+    PrintCalls = PrintCalls + 1;
+    return 0;
+}
+
+#if defined(KERNEL_PI)
+extern "C" float pi();
+static double runKernel(long i) { return pi(); }
+#elif defined(KERNEL_COSINE)
+extern "C" float cosine(float x);
+static double runKernel(long i) {
+    static const float Args[] = {3.14159f, 1.04720f, 2.09440f, 0.5f};
+    return cosine(Args[i & 3]);
+}
+#elif defined(KERNEL_FIBONACCI)
+extern "C" int fibonacci(int n);
+static double runKernel(long i) { return fibonacci(FIB_N); }
+#elif defined(KERNEL_ARR_ADDITION)
+extern "C" int arr_addition(int n, int m);
+static double runKernel(long i) { return arr_addition((int)(i & 1023), 3); }
+#elif defined(KERNEL_MATRIX_MUL)
+extern "C" int matrix_mul(float a[MATRIX_N][MATRIX_N], float b[MATRIX_N][MATRIX_N],
+                          float c[MATRIX_N][MATRIX_N], int n);
+static float A[MATRIX_N][MATRIX_N], B[MATRIX_N][MATRIX_N], C[MATRIX_N][MATRIX_N];
+static double runKernel(long i) {
+    if (i < 0) {
+        for (int r = 0; r < MATRIX_N; r++)
+            for (int c = 0; c < MATRIX_N; c++) {
+                A[r][c] = (float)((r + c) % 7) * 0.5f;
+                B[r][c] = (float)((r * c) % 5) * 0.25f;
+            }
+        memset(C, 0, sizeof(C));
+    }
+    matrix_mul(A, B, C, MATRIX_N);
+    if (i >= 0) return 0;
+    double Sum = 0;
+    for (int r = 0; r < MATRIX_N; r++)
+        for (int c = 0; c < MATRIX_N; c++) Sum += C[r][c];
+    return Sum;
+}
+#else
+#error "define one KERNEL_* macro"
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// timeCalls - seconds taken by Reps consecutive kernel calls
+static double timeCalls(long Reps, volatile double& Sink) {
+    Clock::time_point Start = Clock::now();
+    for (long i = 0; i < Reps; i++) Sink = Sink + runKernel(i);
+    return std::chrono::duration<double>(Clock::now() - Start).count();
+}
+
+int main(int argc, char** argv) {
+    int Trials = argc > 1 ? atoi(argv[1]) : 5;
+    volatile double Sink = 0;
+
+    // Index -1 marks the reference call (kernels may initialise their inputs)
+    double Checksum = runKernel(-1);
+
+    // Grow the batch until one trial takes at least 20ms, then keep the fastest trial
+    long Reps = 1;
+    while (timeCalls(Reps, Sink) < 0.02 && Reps < (1L << 30)) Reps *= 2;
+    double Best = timeCalls(Reps, Sink);
+    for (int t = 1; t < Trials; t++) {
+        double Secs = timeCalls(Reps, Sink);
+        if (Secs < Best) Best = Secs;
+    }
+
+    printf("%.2f %.6g\n", Best * 1e9 / Reps, Checksum);
+
+    // Counters get their own batch so their setup never skews the timings above
+    const char* WantCounters = getenv("BENCH_COUNTERS");
+    if (WantCounters && strcmp(WantCounters, "0") != 0) {
+        PerfCounters Counters;
+        Counters.start();
+        for (long i = 0; i < Reps; i++) Sink = Sink + runKernel(i);
+        Counters.stop();
+        Counters.report(stdout, (double)Reps);
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+#!/bin/bash
+# Parse throughput on expression-heavy MiniC sources: very long flat
+# expressions mixing every binary operator, deeply nested parentheses and
+# long prefix-operator chains. Reports lexing and parsing time (from
+# -ftime-report-json) and parser throughput in tokens per microsecond.
+# The AST dump mccomp prints for every declaration grows with the square of
+# the tree depth, so it is reported in its own column and kept out of the
+# throughput figure.
+#
+# Usage: bench/parse_throughput.sh [shapes...]
+#   shapes: flat logical nested unary (default: all)
+# Environment:
+#   TERMS=500      operands per flat/logical expression
+#   STMTS=40       expression statements per source
+#   DEPTH=300      parenthesis depth for "nested"
+#   CHAIN=200      prefix operators per chain for "unary"
+#   RUNS=3         runs per shape; the fastest parse is reported
+set -e
+
+SHAPES=${*:-"flat logical nested unary"}
+TERMS=${TERMS:-500}
+STMTS=${STMTS:-40}
+DEPTH=${DEPTH:-300}
+CHAIN=${CHAIN:-200}
+RUNS=${RUNS:-3}
+
+DIR="$(cd "$(dirname "$0")/.." && pwd)"
+MCCOMP="$DIR/mccomp"
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+if [ ! -x "$MCCOMP" ]; then
+    echo "mccomp not found - run make first"
+    exit 1
+fi
+
+# gen_source <shape> - write $WORK/<shape>.c and print its token count.
+# Operands are parameters so no folding or division-by-zero check applies.
+gen_source() {
+    awk -v shape="$1" -v terms="$TERMS" -v stmts="$STMTS" -v depth="$DEPTH" \
+        -v chain="$CHAIN" -v out="$WORK/$1.c" 'BEGIN {
+        split("+ - * / %", arith, " ")
+        split("< <= > >= == !=", rel, " ")
+        # int f ( int a , int b , int c ) { int r ; bool q ;
+        tokens = 18
+        printf "int f(int a, int b, int c) {\n    int r;\n    bool q;\n" > out
+        for (s = 0; s < stmts; s++) {
+            if (shape == "flat") {
+                line = "r = a"
+                for (t = 1; t < terms; t++) line = line " " arith[t % 5 + 1] " " (t % 3 == 0 ? "b" : "c")
+                tokens += 2 * terms + 2
+            } else if (shape == "logical") {
+                # (a < b) && (b != c) || ... : 6 tokens per comparison plus a connective
+                line = "q = a < b"
+                for (t = 1; t < terms; t++)
+                    line = line (t % 2 ? " && " : " || ") (t % 3 ? "b" : "c") " " rel[t % 6 + 1] " a + " (t % 3 ? "c" : "b")
+                tokens += 6 * terms
+            } else if (shape == "nested") {
+                line = "r = "
+                for (d = 0; d < depth; d++) line = line "(a " arith[d % 2 + 1] " "
+                line = line "b"
+                for (d = 0; d < depth; d++) line = line ")"
+                tokens += 4 * depth + 4
+            } else if (shape == "unary") {
+                line = "r = "
+                for (u = 0; u < chain; u++) line = line "-"
+                line = line "a"
+                tokens += chain + 4
+            } else {
+                print "unknown shape " shape > "/dev/stderr"
+                exit 1
+            }
+            printf "    %s;\n", line > out
+        }
+        printf "    return r;\n}\n" > out
+        print tokens + 5
+    }'
+}
+
+# phase_ms <json> <phase> - milliseconds recorded for a phase
+phase_ms() {
+    awk -v want="$2" '/"name"/ { found = index($0, "\"" want "\"") > 0 }
+                      found && /"ms"/ { gsub(/[^0-9.e+-]/, "", $2); print $2; exit }' "$1"
+}
+
+echo "mccomp $(git -C "$DIR" rev-parse --short HEAD 2> /dev/null || echo unknown)," \
+     "$STMTS statements per source, best of $RUNS"
+printf "%-8s %10s %9s %10s %11s %12s %11s\n" "shape" "tokens" "KiB" "lex ms" "parse ms" "tokens/us" "AST dump ms"
+
+for SHAPE in $SHAPES; do
+    TOKENS=$(gen_source "$SHAPE")
+    KIB=$(( $(wc -c < "$WORK/$SHAPE.c") / 1024 ))
+    BEST_LEX=
+    BEST_PARSE=
+    BEST_DUMP=
+    for ((RUN = 0; RUN < RUNS; RUN++)); do
+        if ! "$MCCOMP" "$WORK/$SHAPE.c" -ftime-report-json="$WORK/$SHAPE.json" \
+                -o "$WORK/$SHAPE.ll" > /dev/null 2> "$WORK/mccomp.err"; then
+            echo "mccomp failed on $SHAPE:"
+            grep -i error "$WORK/mccomp.err" | head -5
+            exit 1
+        fi
+        LEX=$(phase_ms "$WORK/$SHAPE.json" Lexing)
+        PARSE=$(phase_ms "$WORK/$SHAPE.json" Parsing)
+        DUMP=$(phase_ms "$WORK/$SHAPE.json" "AST printing")
+        if [ -z "$BEST_PARSE" ] || awk -v a="$PARSE" -v b="$BEST_PARSE" 'BEGIN { exit !(a < b) }'; then
+            BEST_LEX=$LEX
+            BEST_PARSE=$PARSE
+            BEST_DUMP=$DUMP
+        fi
+    done
+    awk -v s="$SHAPE" -v n="$TOKENS" -v k="$KIB" -v l="$BEST_LEX" -v p="$BEST_PARSE" -v d="$BEST_DUMP" 'BEGIN {
+        printf "%-8s %10d %9d %10.2f %11.2f %12.1f %11.1f\n", s, n, k, l, p, (p > 0 ? n / (p * 1000) : 0), d
+    }'
+done
@@ -0,0 +1,180 @@
+#ifndef MCCOMP_BENCH_PERF_COUNTERS_H
+#define MCCOMP_BENCH_PERF_COUNTERS_H
+
+// Hardware performance counters for the benchmark drivers (header only).
+//
+//   PerfCounters Counters;
+//   Counters.start();
+//   ... calls into the mccomp-compiled kernel ...
+//   Counters.stop();
+//   Counters.report(stdout, Iterations);
+//
+// On Linux each counter is opened on its own with perf_event_open(2), so a
+// machine (or VM, or container) that only exposes some events still reports
+// those. Counts are scaled when the kernel multiplexes them. Elsewhere, or
+// when perf_event_paranoid / seccomp forbids it, every counter is reported as
+// unavailable together with the reason; nothing fails.
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+class PerfCounters {
+public:
+    enum Event { Cycles, Instructions, BranchMisses, L1DMisses, LLCMisses, NumEvents };
+
+    PerfCounters() {
+        for (int E = 0; E < NumEvents; E++) {
+            FD[E] = -1;
+            Value[E] = 0;
+        }
+#ifdef __linux__
+        for (int E = 0; E < NumEvents; E++) open((Event)E);
+#else
+        Reason = "perf_event_open is only available on Linux";
+#endif
+    }
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int E = 0; E < NumEvents; E++)
+            if (FD[E] >= 0) close(FD[E]);
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    static const char* name(Event E) {
+        static const char* Names[NumEvents] = {"cycles", "instructions", "branch-misses",
+                                               "L1d-misses", "LLC-misses"};
+        return Names[E];
+    }
+
+    bool available(Event E) const { return FD[E] >= 0; }
+
+    bool anyAvailable() const {
+        for (int E = 0; E < NumEvents; E++)
+            if (available((Event)E)) return true;
+        return false;
+    }
+
+    // Why the first counter that failed to open is missing (empty if all opened)
+    const std::string& unavailableReason() const { return Reason; }
+
+    void start() {
+#ifdef __linux__
+        for (int E = 0; E < NumEvents; E++) {
+            if (FD[E] < 0) continue;
+            ioctl(FD[E], PERF_EVENT_IOC_RESET, 0);
+            ioctl(FD[E], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    void stop() {
+#ifdef __linux__
+        for (int E = 0; E < NumEvents; E++)
+            if (FD[E] >= 0) ioctl(FD[E], PERF_EVENT_IOC_DISABLE, 0);
+
+        for (int E = 0; E < NumEvents; E++) {
+            Value[E] = 0;
+            if (FD[E] < 0) continue;
+            // value, time enabled, time running (PERF_FORMAT_TOTAL_TIME_*)
+            uint64_t Data[3] = {0, 0, 0};
+            if (read(FD[E], Data, sizeof(Data)) != (ssize_t)sizeof(Data)) continue;
+            if (Data[2] == 0) continue;
+            Value[E] = Data[2] < Data[1] ? (double)Data[0] * Data[1] / Data[2] : (double)Data[0];
+        }
+#endif
+    }
+
+    // Count for E over the last start()/stop() window, or -1 when unavailable
+    double count(Event E) const { return available(E) ? Value[E] : -1; }
+
+    double ipc() const {
+        if (!available(Cycles) || !available(Instructions) || Value[Cycles] == 0) return -1;
+        return Value[Instructions] / Value[Cycles];
+    }
+
+    // report - one line: IPC and every counter per iteration ("n/a" when missing)
+    void report(FILE* Out, double Iterations) const {
+        if (!anyAvailable()) {
+            fprintf(Out, "counters unavailable: %s\n", Reason.c_str());
+            return;
+        }
+        if (ipc() >= 0)
+            fprintf(Out, "IPC %.2f", ipc());
+        else
+            fprintf(Out, "IPC n/a");
+        for (int E = 0; E < NumEvents; E++) {
+            if (available((Event)E))
+                fprintf(Out, "  %s/iter %.2f", name((Event)E), Value[E] / Iterations);
+            else
+                fprintf(Out, "  %s/iter n/a", name((Event)E));
+        }
+        fprintf(Out, "\n");
+    }
+
+private:
+    int FD[NumEvents];
+    double Value[NumEvents];
+    std::string Reason;
+
+#ifdef __linux__
+    void open(Event E) {
+        struct perf_event_attr Attr;
+        memset(&Attr, 0, sizeof(Attr));
+        Attr.size = sizeof(Attr);
+        Attr.disabled = 1;
+        Attr.exclude_kernel = 1;
+        Attr.exclude_hv = 1;
+        Attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        switch (E) {
+        case Cycles:
+            Attr.type = PERF_TYPE_HARDWARE;
+            Attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case Instructions:
+            Attr.type = PERF_TYPE_HARDWARE;
+            Attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case BranchMisses:
+            Attr.type = PERF_TYPE_HARDWARE;
+            Attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case L1DMisses:
+            Attr.type = PERF_TYPE_HW_CACHE;
+            Attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case LLCMisses:
+            Attr.type = PERF_TYPE_HARDWARE;
+            Attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        default:
+            return;
+        }
+
+        // pid 0, any CPU: count this thread only
+        FD[E] = (int)syscall(SYS_perf_event_open, &Attr, 0, -1, -1, 0);
+        if (FD[E] < 0 && Reason.empty()) {
+            Reason = std::string(name(E)) + ": " + strerror(errno);
+            if (errno == EACCES || errno == EPERM)
+                Reason += " (check /proc/sys/kernel/perf_event_paranoid)";
+        }
+    }
+#endif
+};
+
+#endif // MCCOMP_BENCH_PERF_COUNTERS_H
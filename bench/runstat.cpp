@@ -0,0 +1,47 @@
+// runstat - run a command and report its wall time and peak resident set size.
+//
+// Usage: runstat <command> [args...]
+// Prints "<seconds> <peak RSS in KiB> <exit status>" on stderr; the command's
+// own output is left untouched.
+#include <chrono>
+#include <cstdio>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <command> [args...]\n", argv[0]);
+        return 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return 2;
+    }
+    if (pid == 0) {
+        execvp(argv[1], argv + 1);
+        perror(argv[1]);
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage = {};
+    if (wait4(pid, &status, 0, &usage) < 0) {
+        perror("wait4");
+        return 2;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // ru_maxrss is KiB on Linux but bytes on macOS
+#ifdef __APPLE__
+    long peakKiB = usage.ru_maxrss / 1024;
+#else
+    long peakKiB = usage.ru_maxrss;
+#endif
+    int code = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    fprintf(stderr, "%.4f %ld %d\n", seconds, peakKiB, code);
+    return code;
+}
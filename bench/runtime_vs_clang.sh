@@ -0,0 +1,100 @@
+#!/bin/bash
+# Time mccomp-generated code for the tests/* kernels at each optimization
+# level and compare it with clang compiling the same MiniC source as C.
+# Inputs are scaled up where the kernel allows it (more pi terms, larger
+# matrices, longer Fibonacci runs).
+#
+# Usage: bench/runtime_vs_clang.sh [kernels...]
+#   kernels: pi cosine fibonacci arr_addition matrix_mul (default: all)
+# Environment:
+#   LEVELS="-O0 -O1 -O2 -O3"   optimization levels to compare
+#   MCCOMP_FLAGS=""            extra mccomp flags, e.g. -fwrapv to measure without nsw
+#   MATRIX_N=64                matrix size for matrix_mul
+#   PI_TERMS=1000              loop bound for pi (must stay below ~1290 to avoid int overflow)
+#   CSV=file                   also append "date,commit,kernel,level,mccomp_ns,clang_ns,slowdown"
+#   COUNTERS=1                 also show hardware counters (IPC, misses per call) for both builds
+set -e
+
+export BENCH_COUNTERS=${COUNTERS:-0}
+
+KERNELS=${*:-"pi cosine fibonacci arr_addition matrix_mul"}
+LEVELS=${LEVELS:-"-O0 -O1 -O2 -O3"}
+MCCOMP_FLAGS=${MCCOMP_FLAGS:-}
+MATRIX_N=${MATRIX_N:-64}
+PI_TERMS=${PI_TERMS:-1000}
+
+DIR="$(cd "$(dirname "$0")/.." && pwd)"
+MCCOMP="$DIR/mccomp"
+CLANG=${CLANG:-clang++}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+if [ ! -x "$MCCOMP" ]; then
+    echo "mccomp not found - run make first"
+    exit 1
+fi
+
+# kernel_source <kernel> - write the scaled MiniC source to $WORK/<kernel>.c
+kernel_source() {
+    case $1 in
+        pi)           sed "s/i < 100/i < $PI_TERMS/" "$DIR/tests/pi/pi.c" ;;
+        cosine)       cat "$DIR/tests/cosine/cosine.c" ;;
+        fibonacci)    cat "$DIR/tests/fibonacci/fibonacci.c" ;;
+        arr_addition) cat "$DIR/tests/array_addition/arr_addition.c" ;;
+        matrix_mul)   sed "s/\[10\]/[$MATRIX_N]/g" "$DIR/tests/matrix_multiplication/matrix_mul.c" ;;
+        *) echo "unknown kernel '$1'" >&2; return 1 ;;
+    esac > "$WORK/$1.c"
+}
+
+# run_kernel <kernel> <label> <object> - print "<ns per call> <checksum>". Only
+# objects are linked, so the kernel keeps the code of the level under test.
+run_kernel() {
+    local macro
+    macro=KERNEL_$(tr '[:lower:]' '[:upper:]' <<< "$1")
+    "$CLANG" -O2 -D"$macro" -DMATRIX_N="$MATRIX_N" "$DIR/bench/kernel_driver.cpp" "$3" \
+        -o "$WORK/$1_$2"
+    "$WORK/$1_$2"
+}
+
+COMMIT=$(git -C "$DIR" rev-parse --short HEAD 2> /dev/null || echo unknown)
+echo "mccomp $COMMIT${MCCOMP_FLAGS:+ $MCCOMP_FLAGS} vs $("$CLANG" --version | head -1)"
+printf "%-14s %-5s %14s %14s %10s\n" "kernel" "level" "mccomp ns/call" "clang ns/call" "slowdown"
+
+for KERNEL in $KERNELS; do
+    kernel_source "$KERNEL"
+    for LEVEL in $LEVELS; do
+        (cd "$WORK" && "$MCCOMP" "$KERNEL.c" "$LEVEL" $MCCOMP_FLAGS -c -o "$KERNEL$LEVEL.o" > /dev/null 2>&1) || {
+            printf "%-14s %-5s %14s\n" "$KERNEL" "$LEVEL" "mccomp failed"
+            continue
+        }
+        "$CLANG" -x c -include stdbool.h "$LEVEL" -c "$WORK/$KERNEL.c" -o "$WORK/$KERNEL$LEVEL.clang.o"
+
+        MC_OUT=$(run_kernel "$KERNEL" mccomp "$WORK/$KERNEL$LEVEL.o")
+        CL_OUT=$(run_kernel "$KERNEL" clang "$WORK/$KERNEL$LEVEL.clang.o")
+        read -r MC_NS MC_SUM <<< "$MC_OUT"
+        read -r CL_NS CL_SUM <<< "$CL_OUT"
+        if [ -z "$MC_NS" ] || [ -z "$CL_NS" ]; then
+            printf "%-14s %-5s %14s\n" "$KERNEL" "$LEVEL" "harness failed"
+            continue
+        fi
+
+        # MiniC float literals are single precision where C promotes to double,
+        # so only flag checksums that disagree beyond float rounding
+        awk -v k="$KERNEL" -v l="$LEVEL" -v m="$MC_NS" -v c="$CL_NS" \
+            -v ms="$MC_SUM" -v cs="$CL_SUM" -v csv="$CSV" -v commit="$COMMIT" 'BEGIN {
+            ratio = c > 0 ? m / c : 0
+            d = ms - cs; if (d < 0) d = -d
+            s = cs < 0 ? -cs : cs
+            note = (d > 1e-3 * (s > 1 ? s : 1)) ? "  checksum mismatch: " ms " vs " cs : ""
+            printf "%-14s %-5s %14.1f %14.1f %9.2fx%s\n", k, l, m, c, ratio, note
+            if (csv != "") {
+                "date +%Y-%m-%dT%H:%M:%S" | getline now
+                printf "%s,%s,%s,%s,%.2f,%.2f,%.3f\n", now, commit, k, l, m, c, ratio >> csv
+            }
+        }'
+        if [ "$BENCH_COUNTERS" != "0" ]; then
+            echo "    mccomp: $(sed -n 2p <<< "$MC_OUT")"
+            echo "    clang:  $(sed -n 2p <<< "$CL_OUT")"
+        fi
+    done
+done
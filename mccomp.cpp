@@ -1,5 +1,10 @@
 #include "llvm/ADT/APFloat.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Analysis/ValueTracking.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DerivedTypes.h"
@@ -11,16 +16,35 @@
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Linker/Linker.h"
 #include "llvm/MC/TargetRegistry.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Passes/StandardInstrumentations.h"
+#include "llvm/Support/CodeGen.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h"
 #include "llvm/TargetParser/Host.h"
+#include "llvm/Transforms/IPO/Internalize.h"
+#include "llvm/Transforms/Scalar/SROA.h"
+#include "llvm/Transforms/Scalar/SimplifyCFG.h"
+#include "llvm/Transforms/Scalar/TailRecursionElimination.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cctype>
+#include <chrono>
+#include <climits>
 #include <cstdio>
 #include <cstdlib>
 #include <fstream>
@@ -32,6 +56,9 @@
 #include <string.h>
 #include <string>
 #include <system_error>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
 #include <utility>
 #include <vector>
 
@@ -42,8 +69,9 @@ static LLVMContext TheContext;
 static IRBuilder<> Builder(TheContext);
 static std::unique_ptr<Module> TheModule;
 static std::map<std::string, AllocaInst*> NamedValues;
+static std::map<const Value*, Align> ParamAligns;  // aligned(N) array parameters, by alloca
 static std::map<std::string, GlobalVariable*> GlobalValues;
-static std::map<std::string, std::string> VariableTypes;
+static std::set<std::string> StaticFunctions;  // functions declared "static"
 static Function *CurrentFunction = nullptr;
 
 // Source line cache for better error reporting (forward declarations)
@@ -205,6 +233,218 @@ static void ShowPhaseComplete(const std::string& phase) {
     }
 }
 
+//==============================================================================
+// COMPILER OPTIONS
+// Settings parsed from the command line that steer optimization and emission
+//==============================================================================
+
+struct CompilerOptions {
+    std::string InputFile;           // source currently being compiled
+    std::vector<std::string> InputFiles;  // all inputs (several only with --lto)
+    unsigned OptLevel = 0;           // -O0 .. -O3
+    bool EmitObject = false;         // -c: native object file instead of textual IR
+    bool EmitBitcode = false;        // -emit-llvm-bc: LLVM bitcode instead of textual IR
+    std::string OutputFile;          // -o PATH ("-" = stdout); empty = output.{ll,bc,o}
+    unsigned BackendThreads = 0;     // --backend-threads N (0 = single-module backend)
+    unsigned BackendPartitions = 0;  // --backend-partitions N (0 = default)
+    std::string FunctionCacheDir;    // --function-cache DIR (empty = disabled)
+    std::string CompileCacheDir;     // --compile-cache DIR or MCCOMP_CACHE_DIR (empty = disabled)
+    uint64_t CompileCacheSizeMB = 256;  // --compile-cache-size MB
+    bool LTO = false;                // --lto: link all inputs and optimize them as one module
+    std::vector<std::string> EntryPoints;  // --entry NAME[,NAME...]: symbols kept external
+    bool Internalize = false;        // --internalize: all but the entry points become internal
+    bool SiblingCalls = true;        // tail call marking and -O0 recursion-to-loop
+                                     // (-fno-optimize-sibling-calls disables)
+    bool WrapV = false;              // -fwrapv: signed integer overflow wraps
+    FastMathFlags FPMath;            // -ffast-math, -fno-signed-zeros, -freciprocal-math, ...
+    bool TimeReport = false;         // -ftime-report: phase timings on stderr
+    std::string TimeReportFile;      // -ftime-report-json=FILE: the same as JSON
+    bool TimeTrace = false;          // -ftime-trace[=FILE]: Chrome trace-event JSON
+    std::string TimeTraceFile;       // empty = <output file stem>.time-trace
+    unsigned TimeTraceGranularity = 500;  // -ftime-trace-granularity=N (microseconds)
+    unsigned ArrayAlign = 0;         // --array-align=N: minimum array alignment (0 = natural)
+    unsigned IndexWidth = 32;        // --index-width=N: bits array subscripts are computed in
+};
+
+static CompilerOptions Opts;
+
+// fastMathName - The fast-math flags in effect as IR spells them (" nsz arcp"), or ""
+static std::string fastMathName() {
+    std::string Name;
+    raw_string_ostream OS(Name);
+    Opts.FPMath.print(OS);
+    return OS.str();
+}
+
+// Largest alignment --array-align and aligned(N) accept, one page
+static const unsigned MaxArrayAlignment = 4096;
+
+// isValidArrayAlignment - Array alignments are powers of two up to MaxArrayAlignment
+static bool isValidArrayAlignment(long N) {
+    return N > 0 && N <= MaxArrayAlignment && (N & (N - 1)) == 0;
+}
+
+//==============================================================================
+// TIME REPORT
+// -ftime-report / -ftime-report-json: wall time per compiler phase and function
+//
+// Lexing, parsing and IR generation are interleaved (ParseDecl generates code
+// for each declaration as soon as it is parsed), so phases are measured with
+// nested scopes that pause the enclosing one: every phase is reported exclusive
+// of the others. Only the main thread is timed.
+//==============================================================================
+
+enum class CompilePhase { Lexing, Parsing, ASTDump, Semantic, IRGen, Verify, Optimize, Emit, NumPhases };
+
+static const char* const CompilePhaseNames[] = {
+    "Lexing", "Parsing", "AST printing", "Semantic checks", "IR generation", "Verification",
+    "Optimization", "Emission"};
+
+struct FunctionTimes {
+    double IRGenMs = 0;  // FunctionDeclAST::codegen, inclusive
+    double OptMs = 0;    // function passes run on it
+};
+
+using TimingClock = std::chrono::steady_clock;
+
+static double PhaseMs[static_cast<int>(CompilePhase::NumPhases)];
+static std::map<std::string, FunctionTimes> FunctionTimeTable;
+static const std::thread::id MainThreadId = std::this_thread::get_id();
+
+static bool timeReportRequested() { return Opts.TimeReport || !Opts.TimeReportFile.empty(); }
+
+static bool timingEnabled() {
+    return timeReportRequested() && std::this_thread::get_id() == MainThreadId;
+}
+
+static double elapsedMs(TimingClock::time_point Start, TimingClock::time_point End) {
+    return std::chrono::duration<double, std::milli>(End - Start).count();
+}
+
+// PhaseTimer - Charges the wall time of a scope to a phase, pausing the enclosing timer
+class PhaseTimer {
+    static PhaseTimer* Current;
+    PhaseTimer* Parent = nullptr;
+    CompilePhase Phase;
+    TimingClock::time_point Start;
+    bool Active;
+
+    void charge(TimingClock::time_point Now) {
+        PhaseMs[static_cast<int>(Phase)] += elapsedMs(Start, Now);
+    }
+
+public:
+    explicit PhaseTimer(CompilePhase P) : Phase(P), Active(timingEnabled()) {
+        if (!Active) return;
+        Start = TimingClock::now();
+        Parent = Current;
+        if (Parent) Parent->charge(Start);
+        Current = this;
+    }
+
+    ~PhaseTimer() {
+        if (!Active) return;
+        TimingClock::time_point Now = TimingClock::now();
+        charge(Now);
+        Current = Parent;
+        if (Parent) Parent->Start = Now;
+    }
+};
+
+PhaseTimer* PhaseTimer::Current = nullptr;
+
+// FunctionIRGenTimer - Inclusive IR generation time of one function definition
+class FunctionIRGenTimer {
+    std::string Name;
+    TimingClock::time_point Start;
+    bool Active;
+
+public:
+    FunctionIRGenTimer(const std::string& name, bool isDefinition)
+        : Name(name), Active(isDefinition && timingEnabled()) {
+        if (Active) Start = TimingClock::now();
+    }
+    ~FunctionIRGenTimer() {
+        if (Active) FunctionTimeTable[Name].IRGenMs += elapsedMs(Start, TimingClock::now());
+    }
+};
+
+// getHeaviestFunctions - Functions ordered by IR generation + optimization time
+static std::vector<std::pair<std::string, FunctionTimes>> getHeaviestFunctions() {
+    std::vector<std::pair<std::string, FunctionTimes>> Functions(FunctionTimeTable.begin(),
+                                                                FunctionTimeTable.end());
+    std::stable_sort(Functions.begin(), Functions.end(), [](const auto& A, const auto& B) {
+        return A.second.IRGenMs + A.second.OptMs > B.second.IRGenMs + B.second.OptMs;
+    });
+    return Functions;
+}
+
+// printTimeReport - Human-readable report on stderr
+static void printTimeReport(double TotalMs) {
+    const int NumPhases = static_cast<int>(CompilePhase::NumPhases);
+    double PhaseSum = 0;
+    for (int i = 0; i < NumPhases; i++) PhaseSum += PhaseMs[i];
+    auto Percent = [&](double Ms) { return TotalMs > 0 ? 100.0 * Ms / TotalMs : 0.0; };
+
+    fprintf(stderr, "\n%s===-------------------------------------------------------===%s\n",
+            COLOR_BOLD, COLOR_RESET);
+    fprintf(stderr, "%s                  MiniC compile time report%s\n", COLOR_BOLD, COLOR_RESET);
+    fprintf(stderr, "%s===-------------------------------------------------------===%s\n",
+            COLOR_BOLD, COLOR_RESET);
+    fprintf(stderr, "  %-28s %12s %8s\n", "Phase", "Wall (ms)", "%");
+    for (int i = 0; i < NumPhases; i++)
+        fprintf(stderr, "  %-28s %12.3f %7.1f%%\n", CompilePhaseNames[i], PhaseMs[i],
+                Percent(PhaseMs[i]));
+    fprintf(stderr, "  %-28s %12.3f %7.1f%%\n", "Other", TotalMs - PhaseSum,
+            Percent(TotalMs - PhaseSum));
+    fprintf(stderr, "  %-28s %12.3f %7.1f%%\n", "Total", TotalMs, 100.0);
+
+    const size_t MaxFunctions = 10;
+    auto Functions = getHeaviestFunctions();
+    if (Functions.empty()) return;
+    fprintf(stderr, "\n  %-28s %12s %12s\n", "Heaviest functions", "IR gen (ms)", "Opt (ms)");
+    for (size_t i = 0; i < Functions.size() && i < MaxFunctions; i++)
+        fprintf(stderr, "  %-28s %12.3f %12.3f\n", Functions[i].first.c_str(),
+                Functions[i].second.IRGenMs, Functions[i].second.OptMs);
+    if (Functions.size() > MaxFunctions)
+        fprintf(stderr, "  ... %zu more (see -ftime-report-json)\n", Functions.size() - MaxFunctions);
+}
+
+// writeTimeReportJSON - Machine-readable report with every phase and function
+static void writeTimeReportJSON(const std::string& Path, double TotalMs) {
+    std::error_code EC;
+    raw_fd_ostream OS(Path, EC, sys::fs::OF_Text);
+    if (EC) {
+        errs() << "Warning: cannot write time report '" << Path << "': " << EC.message() << "\n";
+        return;
+    }
+
+    json::OStream J(OS, 2);
+    J.object([&] {
+        J.attributeArray("inputs", [&] {
+            for (const auto& Input : Opts.InputFiles) J.value(Input);
+        });
+        J.attribute("opt_level", static_cast<int64_t>(Opts.OptLevel));
+        J.attribute("total_ms", TotalMs);
+        J.attributeArray("phases", [&] {
+            for (int i = 0; i < static_cast<int>(CompilePhase::NumPhases); i++)
+                J.object([&] {
+                    J.attribute("name", CompilePhaseNames[i]);
+                    J.attribute("ms", PhaseMs[i]);
+                });
+        });
+        J.attributeArray("functions", [&] {
+            for (const auto& [Name, Times] : getHeaviestFunctions())
+                J.object([&] {
+                    J.attribute("name", Name);
+                    J.attribute("irgen_ms", Times.IRGenMs);
+                    J.attribute("opt_ms", Times.OptMs);
+                });
+        });
+    });
+    OS << "\n";
+}
+
 //===----------------------------------------------------------------------===//
 //===----------------------------------------------------------------------===//
 
@@ -216,43 +456,93 @@ enum class ErrorType {
     SEMANTIC_OTHER
 };
 
-// Helper: Calculate Levenshtein distance for "did you mean?" suggestions
-static int levenshteinDistance(const std::string& s1, const std::string& s2) {
-    const size_t len1 = s1.size(), len2 = s2.size();
-    std::vector<std::vector<int>> d(len1 + 1, std::vector<int>(len2 + 1));
-
-    for (size_t i = 0; i <= len1; ++i) d[i][0] = i;
-    for (size_t j = 0; j <= len2; ++j) d[0][j] = j;
-
-    for (size_t i = 1; i <= len1; ++i) {
-        for (size_t j = 1; j <= len2; ++j) {
+// levenshteinDistance - Edit distance between s1 and s2, or maxDist + 1 as soon as
+// it is known to exceed maxDist. Only two rows and the diagonal band of width
+// 2 * maxDist + 1 are computed, so rejecting a candidate costs O(maxDist * length).
+static int levenshteinDistance(const std::string& s1, const std::string& s2, int maxDist) {
+    const int len1 = s1.size(), len2 = s2.size();
+    const int tooFar = maxDist + 1;
+    if (std::abs(len1 - len2) > maxDist) return tooFar;
+
+    // Reused between calls; the frontend is single-threaded
+    static std::vector<int> prev, cur;
+    prev.assign(len2 + 2, tooFar);
+    cur.assign(len2 + 2, tooFar);
+    for (int j = 0; j <= std::min(len2, maxDist); ++j) prev[j] = j;
+
+    for (int i = 1; i <= len1; ++i) {
+        const int lo = std::max(1, i - maxDist), hi = std::min(len2, i + maxDist);
+        cur[lo - 1] = (lo == 1 && i <= maxDist) ? i : tooFar;
+        int rowMin = cur[lo - 1];
+        for (int j = lo; j <= hi; ++j) {
             int cost = (s1[i - 1] == s2[j - 1]) ? 0 : 1;
-            d[i][j] = std::min({d[i - 1][j] + 1, d[i][j - 1] + 1, d[i - 1][j - 1] + cost});
+            cur[j] = std::min({prev[j - 1] + cost, prev[j] + 1, cur[j - 1] + 1, tooFar});
+            rowMin = std::min(rowMin, cur[j]);
         }
+        cur[hi + 1] = tooFar;  // the next row's band reaches one column further
+        if (rowMin > maxDist) return tooFar;
+        std::swap(prev, cur);
     }
-    return d[len1][len2];
+    return prev[len2];
 }
 
-// Find closest match from a list of options
-static std::string findClosestMatch(const std::string& target, const std::vector<std::string>& options) {
-    if (options.empty() || target.empty()) return "";
-
-    int minDist = INT_MAX;
-    std::string closest;
+// SuggestionIndex - Names bucketed by length for "did you mean?" lookups. A query
+// only visits the buckets within the distance bound and tightens the bound as
+// closer names are found, instead of scoring every symbol in the program.
+class SuggestionIndex {
+    std::map<size_t, std::set<std::string>> ByLength;
+    std::set<std::string> Sorted;  // for prefix lookups
 
-    for (const auto& option : options) {
-        int dist = levenshteinDistance(target, option);
-        if (dist < minDist) {
-            minDist = dist;
-            closest = option;
+public:
+    void insert(const std::string& Name) {
+        if (Sorted.insert(Name).second) ByLength[Name.size()].insert(Name);
+    }
+
+    void erase(const std::string& Name) {
+        if (!Sorted.erase(Name)) return;
+        auto Bucket = ByLength.find(Name.size());
+        Bucket->second.erase(Name);
+        if (Bucket->second.empty()) ByLength.erase(Bucket);
+    }
+
+    void clear() {
+        ByLength.clear();
+        Sorted.clear();
+    }
+
+    // closest - Nearest name within MaxDist edits (ties go to the smallest name), or ""
+    std::string closest(const std::string& Target, int MaxDist) const {
+        int Best = MaxDist + 1;
+        const std::string* BestName = nullptr;
+        size_t MinLen = Target.size() > (size_t)MaxDist ? Target.size() - MaxDist : 0;
+        for (auto It = ByLength.lower_bound(MinLen);
+             It != ByLength.end() && It->first <= Target.size() + MaxDist; ++It) {
+            for (const std::string& Name : It->second) {
+                int Dist = levenshteinDistance(Target, Name, Best);
+                if (Dist < Best || (Dist == Best && Dist <= MaxDist && Name < *BestName)) {
+                    Best = Dist;
+                    BestName = &Name;
+                }
+            }
         }
+        return BestName ? *BestName : "";
     }
 
-    // Only suggest if the distance is reasonable (not too different)
-    if (minDist <= 2 && minDist < static_cast<int>(target.length())) {
-        return closest;
+    // withPrefix - Smallest name starting with Prefix, or ""
+    std::string withPrefix(const std::string& Prefix) const {
+        auto It = Sorted.lower_bound(Prefix);
+        if (It != Sorted.end() && It->compare(0, Prefix.size(), Prefix) == 0) return *It;
+        return "";
     }
-    return "";
+};
+
+// Find closest match among the indexed names
+static std::string findClosestMatch(const std::string& target, const SuggestionIndex& options) {
+    if (target.empty()) return "";
+
+    // Only suggest if the distance is reasonable (not too different)
+    int maxDist = std::min(2, static_cast<int>(target.length()) - 1);
+    return options.closest(target, maxDist);
 }
 
 class CompilerError {
@@ -426,18 +716,98 @@ static std::string getTypeName(Type* T) {
     return typeStr;
 }
 
+//==============================================================================
+// MINIC TYPES
+// Type descriptors built once by the parser and interned, so two declarations
+// of the same type share one MiniCType and compare by pointer. Each carries the
+// llvm::Type it lowers to; codegen never re-derives a type from its spelling.
+//==============================================================================
+
+// MiniCType - Scalar kind, array dimensions and pointer-ness of a MiniC type.
+// Array parameters decay to a pointer to their first dimension and keep the
+// others: "int a[10][5]" as a parameter is int*[5], a pointer to rows of 5 ints
+struct MiniCType {
+    enum ScalarKind { Void, Int, Float, Bool };
+
+    ScalarKind Scalar;
+    bool IsPointer;
+    std::vector<int> Dims;   // array dimensions, or the trailing ones of a pointer
+    int Lanes;               // SIMD width of the elements, 0 when they are scalars
+    std::string Name;        // source spelling: "int", "float*", "int[10][5]", "float4[8]"
+    Type* LLVMTy;            // type of the value itself: scalar, vector, ptr or nested array
+    Type* ElementTy;         // type of the elements: the scalar, or <Lanes x scalar>
+    Type* PointeeTy;         // what a pointer steps over: ElementTy or an [n x ...] row
+
+    bool isScalar() const { return !IsPointer && Dims.empty() && !Lanes; }
+    bool isVector() const { return !IsPointer && Dims.empty() && Lanes; }
+    bool isArray() const { return !IsPointer && !Dims.empty(); }
+    bool isPointer() const { return IsPointer; }
+
+    const char* scalarName() const {
+        static const char* const Names[] = {"void", "int", "float", "bool"};
+        return Names[Scalar];
+    }
+
+    // elementName - Spelling of the element type: "float" or "float4"
+    std::string elementName() const {
+        return Lanes ? scalarName() + std::to_string(Lanes) : scalarName();
+    }
+};
+
+static std::map<std::tuple<int, bool, std::vector<int>, int>, std::unique_ptr<MiniCType>> MiniCTypes;
+
+// getMiniCType - The interned MiniCType for a scalar kind, pointer-ness, dimensions and
+// vector width
+static const MiniCType* getMiniCType(MiniCType::ScalarKind Scalar, bool IsPointer = false,
+                                     const std::vector<int>& Dims = {}, int Lanes = 0) {
+    auto Key = std::make_tuple(static_cast<int>(Scalar), IsPointer, Dims, Lanes);
+    auto It = MiniCTypes.find(Key);
+    if (It != MiniCTypes.end()) return It->second.get();
+
+    auto T = std::make_unique<MiniCType>();
+    T->Scalar = Scalar;
+    T->IsPointer = IsPointer;
+    T->Dims = Dims;
+
+    switch (Scalar) {
+    case MiniCType::Void: T->ElementTy = Type::getVoidTy(TheContext); break;
+    case MiniCType::Int: T->ElementTy = Type::getInt32Ty(TheContext); break;
+    case MiniCType::Float: T->ElementTy = Type::getFloatTy(TheContext); break;
+    case MiniCType::Bool: T->ElementTy = Type::getInt1Ty(TheContext); break;
+    }
+    T->Lanes = Lanes;
+    if (Lanes) T->ElementTy = FixedVectorType::get(T->ElementTy, Lanes);
+
+    // For int[10][5] this builds [10 x [5 x i32]]; for int*[5] the row [5 x i32]
+    Type* Nested = T->ElementTy;
+    for (int i = Dims.size() - 1; i >= 0; i--) Nested = ArrayType::get(Nested, Dims[i]);
+
+    T->Name = T->elementName();
+    if (IsPointer) T->Name += "*";
+    for (int Dim : Dims) T->Name += "[" + std::to_string(Dim) + "]";
+
+    T->LLVMTy = IsPointer ? PointerType::get(TheContext, 0) : Nested;
+    T->PointeeTy = IsPointer ? Nested : nullptr;
+
+    return (MiniCTypes[Key] = std::move(T)).get();
+}
+
 struct TypeInfo {
-    std::string typeName;  // "int", "float", "bool", "void"
+    const MiniCType* type;  // nullptr when unknown
     bool isGlobal;
     int line;
     int column;
 
-    TypeInfo() : typeName("unknown"), isGlobal(false), line(-1), column(-1) {}
-    TypeInfo(const std::string& name, bool global = false, int l = -1, int c = -1)
-        : typeName(name), isGlobal(global), line(l), column(c) {}
+    TypeInfo() : type(nullptr), isGlobal(false), line(-1), column(-1) {}
+    TypeInfo(const MiniCType* t, bool global = false, int l = -1, int c = -1)
+        : type(t), isGlobal(global), line(l), column(c) {}
+
+    const char* typeName() const { return type ? type->Name.c_str() : "unknown"; }
 };
 
 static std::map<std::string, TypeInfo> SymbolTypeTable;
+static SuggestionIndex SymbolNameIndex;    // keys of SymbolTypeTable
+static SuggestionIndex FunctionNameIndex;  // functions declared so far
 
 
 static TypeInfo* getTypeInfo(const std::string& varName) {
@@ -461,7 +831,7 @@ static void DUMP_SYMBOL_TABLE() {
             for (const auto& pair : SymbolTypeTable) {
                 fprintf(stderr, "    %s: %s (%s) [line:%d, col:%d]\n",
                         pair.first.c_str(),
-                        pair.second.typeName.c_str(),
+                        pair.second.typeName(),
                         pair.second.isGlobal ? "global" : "local",
                         pair.second.line,
                         pair.second.column);
@@ -566,6 +936,9 @@ enum TOKEN_TYPE {
   VOID_TOK = -3,  // "void"
   FLOAT_TOK = -4, // "float"
   BOOL_TOK = -5,  // "bool"
+  INT4_TOK = -24,   // "int4"
+  FLOAT4_TOK = -25, // "float4"
+  FLOAT8_TOK = -26, // "float8"
 
   // keywords
   EXTERN = -6,  // "extern"
@@ -573,6 +946,7 @@ enum TOKEN_TYPE {
   ELSE = -8,    // "else"
   WHILE = -9,   // "while"
   RETURN = -10, // "return"
+  STATIC = -11, // "static"
   // TRUE   = -12,     // "true"
   // FALSE   = -13,     // "false"
 
@@ -610,6 +984,8 @@ enum TOKEN_TYPE {
 
 static std::string globalLexeme;
 static int lineNo, columnNo;
+static int LastChar = ' ';  // lexer lookahead, file scope so it can be reset between inputs
+static int NextChar = ' ';
 
 void TOKEN::validateType(int expectedType, const char* methodName) const {
   if (type != expectedType) {
@@ -651,9 +1027,6 @@ static TOKEN returnTok(const std::string& lexVal, int tok_type) {
 // gettok - Return the next token from standard input.
 static TOKEN gettok() {
 
-  static int LastChar = ' ';
-  static int NextChar = ' ';
-
   // Skip any whitespace.
   while (isspace(LastChar)) {
     if (LastChar == '\n' || LastChar == '\r') {
@@ -676,8 +1049,9 @@ static TOKEN gettok() {
 
     static const std::map<std::string, int> keywords = {
       {"int", INT_TOK}, {"bool", BOOL_TOK}, {"float", FLOAT_TOK}, {"void", VOID_TOK},
+      {"int4", INT4_TOK}, {"float4", FLOAT4_TOK}, {"float8", FLOAT8_TOK},
       {"extern", EXTERN}, {"if", IF}, {"else", ELSE}, {"while", WHILE}, {"return", RETURN},
-      {"true", BOOL_LIT}, {"false", BOOL_LIT}
+      {"static", STATIC}, {"true", BOOL_LIT}, {"false", BOOL_LIT}
     };
 
     auto it = keywords.find(globalLexeme);
@@ -801,11 +1175,35 @@ static TOKEN gettok() {
 static TOKEN CurTok;
 static std::deque<TOKEN> tok_buffer;
 
+// Text of the tokens consumed while parsing one top-level declaration, plus the
+// identifiers it mentions. Used to key the per-function cache (--function-cache).
+struct TokenRecording {
+  std::string Text;
+  std::set<std::string> Identifiers;
+};
+
+static TokenRecording *ActiveRecording = nullptr;
+
+// Records every token consumed for as long as it is in scope
+struct TokenRecordingScope {
+  TokenRecording Recording;
+  TokenRecordingScope() { ActiveRecording = &Recording; }
+  ~TokenRecordingScope() { ActiveRecording = nullptr; }
+};
+
 // Get the next token from our buffer (or fetch a new one if buffer is empty)
 // This implements a lookahead buffer for LL(k) parsing
 static TOKEN getNextToken() {
+  // The token being consumed belongs to the declaration being recorded
+  if (ActiveRecording) {
+    ActiveRecording->Text += CurTok.lexeme;
+    ActiveRecording->Text += ' ';
+    if (CurTok.type == IDENT) ActiveRecording->Identifiers.insert(CurTok.lexeme);
+  }
+
   // Lazy load: only fetch new tokens when buffer is empty
   if (tok_buffer.empty()) {
+    PhaseTimer Timer(CompilePhase::Lexing);
     tok_buffer.emplace_back(gettok());
   }
 
@@ -825,6 +1223,7 @@ static void putBackToken(TOKEN tok) {
 static TOKEN peekToken(int offset = 0) {
   // Fill the buffer with enough tokens to satisfy the lookahead request
   while (tok_buffer.size() <= static_cast<size_t>(offset)) {
+    PhaseTimer Timer(CompilePhase::Lexing);
     tok_buffer.emplace_back(gettok());
   }
   return tok_buffer[offset];
@@ -846,13 +1245,25 @@ static TOKEN peekNextToken() {
 // - Arrays: ArrayAccessAST, ArrayAssignmentExprAST
 //==============================================================================
 
+struct DefiniteAssignment;
+
 class ASTnode {
 
+protected:
+  const MiniCType *ResolvedType = nullptr; // type of an expression, set by sema()
+
 public:
   virtual ~ASTnode() {}
   virtual Value *codegen() { return nullptr; };
+  virtual bool sema() { return true; };
+  virtual void checkAssigned(DefiniteAssignment &DA) {}
+  virtual Value *codegenWideIndex(int64_t &Min, int64_t &Max);
   virtual std::string to_string() const { return ""; };
   virtual bool isArrayAccess() const { return false; }
+  virtual bool isVariable() const { return false; }
+  // getIntConstant - Value of an integer literal, possibly negated, if this is one
+  virtual bool getIntConstant(int64_t &C) const { return false; }
+  const MiniCType *getResolvedType() const { return ResolvedType; }
 };
 
 // integer literals like 1, 2, 10
@@ -866,7 +1277,13 @@ public:
   const std::string &getType() const { return Tok.lexeme; }
   int getValue() const { return Val; }
 
+  virtual bool getIntConstant(int64_t &C) const override {
+    C = Val;
+    return true;
+  }
   virtual Value *codegen() override;
+  virtual Value *codegenWideIndex(int64_t &Min, int64_t &Max) override;
+  virtual bool sema() override;
 
   virtual std::string to_string() const override {
     return std::string(COLOR_CYAN) + "IntLiteral" + std::string(COLOR_RESET) + "(" +
@@ -886,6 +1303,7 @@ public:
   bool getValue() const { return Bool; }
 
   virtual Value *codegen() override;
+  virtual bool sema() override;
 
   virtual std::string to_string() const override {
     return std::string(COLOR_CYAN) + "BoolLiteral" + std::string(COLOR_RESET) + "(" +
@@ -905,6 +1323,7 @@ public:
   double getValue() const { return Val; }
 
   virtual Value *codegen() override;
+  virtual bool sema() override;
 
   virtual std::string to_string() const override {
     return std::string(COLOR_CYAN) + "FloatLiteral" + std::string(COLOR_RESET) + "(" +
@@ -929,7 +1348,10 @@ public:
   const std::string &getType() const { return Tok.lexeme; }
   const IDENT_TYPE getVarType() const { return VarType; }
 
+  virtual bool isVariable() const override { return true; }
   virtual Value *codegen() override;
+  virtual bool sema() override;
+  virtual void checkAssigned(DefiniteAssignment &DA) override;
 
   virtual std::string to_string() const override {
     return std::string(COLOR_GREEN) + "VarRef" + std::string(COLOR_RESET) + "(" +
@@ -940,39 +1362,46 @@ public:
 // a parameter declaration
 class ParamAST {
   std::string Name;
-  std::string Type;
+  const MiniCType *Type;
+  unsigned Alignment; // aligned(N) on an array parameter, 0 if absent
 
 public:
-  ParamAST(const std::string &name, const std::string &type)
-      : Name(name), Type(type) {}
+  ParamAST(const std::string &name, const MiniCType *type, unsigned alignment = 0)
+      : Name(name), Type(type), Alignment(alignment) {}
   const std::string &getName() const { return Name; }
-  const std::string &getType() const { return Type; }
+  const MiniCType *getType() const { return Type; }
+  unsigned getAlignment() const { return Alignment; }
 };
 
 // DeclAST - Base class for declarations, variables and functions
 class DeclAST : public ASTnode {
+  bool ZeroInit = true; // cleared when definite assignment proves no read precedes a write
 
 public:
   virtual ~DeclAST() {}
+  bool needsZeroInit() const { return ZeroInit; }
+  void setNeedsZeroInit(bool Needed) { ZeroInit = Needed; }
   virtual const std::string &getName() const = 0;
-  virtual const std::string &getType() const = 0;
+  virtual const MiniCType *getType() const = 0;
   virtual bool isArray() const { return false; }
 };
 
 // a variable declaration
 class VarDeclAST : public DeclAST {
   std::unique_ptr<VariableASTnode> Var;
-  std::string Type;
+  const MiniCType *Type;
 
 public:
-  VarDeclAST(std::unique_ptr<VariableASTnode> var, const std::string &type)
+  VarDeclAST(std::unique_ptr<VariableASTnode> var, const MiniCType *type)
       : Var(std::move(var)), Type(type) {}
-  const std::string &getType() const override { return Type; }
+  const MiniCType *getType() const override { return Type; }
   const std::string &getName() const override { return Var->getName(); }
 
+  virtual bool sema() override;
+
   virtual std::string to_string() const override {
     return std::string(COLOR_CYAN) + "VarDecl" + std::string(COLOR_RESET) + " [" +
-           std::string(COLOR_YELLOW) + Type + std::string(COLOR_RESET) + " " +
+           std::string(COLOR_YELLOW) + Type->Name + std::string(COLOR_RESET) + " " +
            std::string(COLOR_BOLD) + Var->getName() + std::string(COLOR_RESET) + "]";
   }
 };
@@ -980,19 +1409,23 @@ public:
 // a Global variable declaration
 class GlobVarDeclAST : public DeclAST {
   std::unique_ptr<VariableASTnode> Var;
-  std::string Type;
+  const MiniCType *Type;
+  bool IsStatic;
 
 public:
-  GlobVarDeclAST(std::unique_ptr<VariableASTnode> var, const std::string &type)
-      : Var(std::move(var)), Type(type) {}
-  const std::string &getType() const override { return Type; }
+  GlobVarDeclAST(std::unique_ptr<VariableASTnode> var, const MiniCType *type,
+                 bool isStatic = false)
+      : Var(std::move(var)), Type(type), IsStatic(isStatic) {}
+  const MiniCType *getType() const override { return Type; }
   const std::string &getName() const override { return Var->getName(); }
+  bool isStatic() const { return IsStatic; }
 
   virtual Value *codegen() override;
+  virtual bool sema() override;
 
   virtual std::string to_string() const override {
     return std::string(COLOR_CYAN) + "GlobalVarDecl" + std::string(COLOR_RESET) + " [" +
-           std::string(COLOR_YELLOW) + Type + std::string(COLOR_RESET) + " " +
+           std::string(COLOR_YELLOW) + Type->Name + std::string(COLOR_RESET) + " " +
            std::string(COLOR_BOLD) + Var->getName() + std::string(COLOR_RESET) + "]";
   }
 };
@@ -1000,34 +1433,43 @@ public:
 // array declarations (1D, 2D, 3D)
 class ArrayDeclAST : public DeclAST {
   std::string Name;
-  std::string Type;
-  std::vector<int> Dimensions; // Stores 1-3 dimension sizes
+  const MiniCType *Type; // the whole array type, e.g. int[10][5]
   bool IsGlobal;
+  bool IsStatic;
+  unsigned Alignment;    // aligned(N), 0 if absent
 
 public:
-  ArrayDeclAST(const std::string &name, const std::string &type,
-               std::vector<int> dims, bool isGlobal = false)
-      : Name(name), Type(type), Dimensions(std::move(dims)), IsGlobal(isGlobal) {}
+  ArrayDeclAST(const std::string &name, const MiniCType *elementType,
+               const std::vector<int> &dims, bool isGlobal = false, bool isStatic = false,
+               unsigned alignment = 0)
+      : Name(name), Type(getMiniCType(elementType->Scalar, false, dims, elementType->Lanes)),
+        IsGlobal(isGlobal), IsStatic(isStatic), Alignment(alignment) {}
 
   const std::string &getName() const override { return Name; }
-  const std::string &getType() const override { return Type; }
-  const std::vector<int> &getDimensions() const { return Dimensions; }
+  const MiniCType *getType() const override { return Type; }
+  const std::vector<int> &getDimensions() const { return Type->Dims; }
   bool isGlobal() const { return IsGlobal; }
+  bool isStatic() const { return IsStatic; }
+  // The declared aligned(N), else --array-align; 0 keeps the natural alignment
+  unsigned getAlignment() const { return Alignment ? Alignment : Opts.ArrayAlign; }
   virtual bool isArray() const override { return true; }
 
   virtual Value *codegen() override;
+  virtual bool sema() override;
 
   virtual std::string to_string() const override {
     std::string result = std::string(COLOR_CYAN);
     result += (IsGlobal ? "GlobalArrayDecl" : "ArrayDecl");
     result += std::string(COLOR_RESET) + " [" +
-              std::string(COLOR_YELLOW) + Type + std::string(COLOR_RESET) + " " +
+              std::string(COLOR_YELLOW) + Type->elementName() + std::string(COLOR_RESET) + " " +
               std::string(COLOR_BOLD) + Name + std::string(COLOR_RESET);
 
     // Add dimension info
-    for (size_t i = 0; i < Dimensions.size(); i++) {
-      result += "[" + std::to_string(Dimensions[i]) + "]";
+    for (int Dim : Type->Dims) {
+      result += "[" + std::to_string(Dim) + "]";
     }
+    if (Alignment)
+      result += " aligned(" + std::to_string(Alignment) + ")";
     result += "]";
     return result;
   }
@@ -1037,6 +1479,8 @@ public:
 class ArrayAccessAST : public ASTnode {
   std::string Name;
   std::vector<std::unique_ptr<ASTnode>> Indices; // Stores 1-3 index expressions
+  const MiniCType *BaseType = nullptr;           // the array or array parameter, set by sema()
+  bool LaneAccess = false;                       // the last subscript selects a vector lane
 
 public:
   ArrayAccessAST(const std::string &name,
@@ -1045,9 +1489,15 @@ public:
 
   const std::string &getName() const { return Name; }
   std::vector<std::unique_ptr<ASTnode>> &getIndices() { return Indices; }
+  const MiniCType *getBaseType() const { return BaseType; }
+  bool isLaneAccess() const { return LaneAccess; }
 
   virtual bool isArrayAccess() const override { return true; }
   virtual Value *codegen() override;
+  virtual bool sema() override;
+  virtual void checkAssigned(DefiniteAssignment &DA) override;
+  bool semaBase();
+  Value *codegenAddress();
 
   virtual std::string to_string() const override {
     std::string result = std::string(COLOR_CYAN) + "ArrayAccess" + std::string(COLOR_RESET) +
@@ -1068,20 +1518,25 @@ public:
 // a function declaration's signature
 class FunctionPrototypeAST {
   std::string Name;
-  std::string Type;
+  const MiniCType *Type; // return type
   std::vector<std::unique_ptr<ParamAST>> Params; // vector of parameters
+  bool IsStatic;
 
 public:
-  FunctionPrototypeAST(const std::string &name, const std::string &type,
-                       std::vector<std::unique_ptr<ParamAST>> params)
-      : Name(name), Type(type), Params(std::move(params)) {}
+  FunctionPrototypeAST(const std::string &name, const MiniCType *type,
+                       std::vector<std::unique_ptr<ParamAST>> params,
+                       bool isStatic = false)
+      : Name(name), Type(type), Params(std::move(params)), IsStatic(isStatic) {}
 
   const std::string &getName() const { return Name; }
-  const std::string &getType() const { return Type; }
+  const MiniCType *getType() const { return Type; }
+  bool isStatic() const { return IsStatic; }
   int getSize() const { return Params.size(); }
   std::vector<std::unique_ptr<ParamAST>> &getParams() { return Params; }
 
   Function* codegen();
+  void addParamAlignments(Function *TheFunction);
+  bool sema();
 
   std::string to_string() const {
     std::string result = std::string(COLOR_CYAN) + "FunctionProto" + std::string(COLOR_RESET) + " '" +
@@ -1089,7 +1544,7 @@ public:
 
     result += ASTPrint::indent() + ASTPrint::BRANCH;
     result += std::string(COLOR_BLUE) + "ReturnType: " + std::string(COLOR_RESET) +
-             std::string(COLOR_YELLOW) + Type + std::string(COLOR_RESET) + "\n";
+             std::string(COLOR_YELLOW) + Type->Name + std::string(COLOR_RESET) + "\n";
 
     result += ASTPrint::indent() + ASTPrint::LAST_BRANCH;
     result += std::string(COLOR_BLUE) + "Parameters (" + std::to_string(Params.size()) +
@@ -1103,7 +1558,7 @@ public:
       for (size_t i = 0; i < Params.size(); i++) {
         bool isLast = (i == Params.size() - 1);
         result += ASTPrint::indent() + ASTPrint::treePrefix(isLast);
-        result += std::string(COLOR_YELLOW) + Params[i]->getType() + std::string(COLOR_RESET) + " " +
+        result += std::string(COLOR_YELLOW) + Params[i]->getType()->Name + std::string(COLOR_RESET) + " " +
                  std::string(COLOR_BOLD) + Params[i]->getName() + std::string(COLOR_RESET);
         if (!isLast) result += "\n";
       }
@@ -1137,6 +1592,8 @@ public:
       : LocalDecls(std::move(localDecls)), Stmts(std::move(stmts)) {}
 
   virtual Value *codegen() override;
+  virtual bool sema() override;
+  virtual void checkAssigned(DefiniteAssignment &DA) override;
 
   virtual std::string to_string() const override {
     std::string result = std::string(COLOR_CYAN) + "Block" + std::string(COLOR_RESET) + "\n";
@@ -1206,6 +1663,8 @@ public:
   std::unique_ptr<ASTnode> &getRHS() { return RHS; }
 
   virtual Value* codegen() override;
+  virtual bool sema() override;
+  virtual void checkAssigned(DefiniteAssignment &DA) override;
 
   virtual std::string to_string() const override {
     std::string result = std::string(COLOR_MAGENTA) + "ArrayAssignmentExpr" + std::string(COLOR_RESET) + "\n";
@@ -1246,9 +1705,11 @@ public:
       : Proto(std::move(Proto)), Block(std::move(Block)) {}
 
   const std::string &getName() const override { return Proto->getName(); }
-  const std::string &getType() const override { return Proto->getType(); }
+  const MiniCType *getType() const override { return Proto->getType(); }
+  FunctionPrototypeAST &getProto() { return *Proto; }
 
   virtual Value *codegen() override;
+  virtual bool sema() override;
 
   virtual std::string to_string() const override {
     std::string result = std::string(COLOR_GREEN) + std::string(COLOR_BOLD) + "╔═══ FunctionDecl ═══╗"
@@ -1284,6 +1745,8 @@ public:
       : Cond(std::move(Cond)), Then(std::move(Then)), Else(std::move(Else)) {}
 
   virtual Value *codegen() override;
+  virtual bool sema() override;
+  virtual void checkAssigned(DefiniteAssignment &DA) override;
 
   virtual std::string to_string() const override {
     std::string result = std::string(COLOR_MAGENTA) + "IfStmt" + std::string(COLOR_RESET) + "\n";
@@ -1356,6 +1819,8 @@ public:
       : Cond(std::move(cond)), Body(std::move(body)) {}
 
   virtual Value *codegen() override;
+  virtual bool sema() override;
+  virtual void checkAssigned(DefiniteAssignment &DA) override;
 
   virtual std::string to_string() const override {
     std::string result = std::string(COLOR_MAGENTA) + "WhileStmt" + std::string(COLOR_RESET) + "\n";
@@ -1384,11 +1849,14 @@ public:
 // a return value
 class ReturnAST : public ASTnode {
   std::unique_ptr<ASTnode> Val;
+  const MiniCType *FunctionReturnType = nullptr; // the value is converted to this
 
 public:
   ReturnAST(std::unique_ptr<ASTnode> value) : Val(std::move(value)) {}
 
   virtual Value *codegen() override;
+  virtual bool sema() override;
+  virtual void checkAssigned(DefiniteAssignment &DA) override;
 
   virtual std::string to_string() const override {
     if (Val) {
@@ -1455,8 +1923,8 @@ static std::unique_ptr<FunctionPrototypeAST> LogErrorP(TOKEN tok, const char *St
 static Value* LogErrorV(const char *Str) { LogErr(ErrorType::SEMANTIC_OTHER, Str); return nullptr; }
 static Value* LogErrorV(const std::string& Str) { return LogErrorV(Str.c_str()); }
 
-static Value* LogTypeError(const std::string& msg, Type* expected, Type* actual) {
-    LogErr(ErrorType::SEMANTIC_TYPE, msg + "\n  Expected: " + getTypeName(expected) + "\n  Actual: " + getTypeName(actual));
+static Value* LogTypeError(const std::string& msg, const MiniCType* expected, const MiniCType* actual) {
+    LogErr(ErrorType::SEMANTIC_TYPE, msg + "\n  Expected: " + expected->Name + "\n  Actual: " + actual->Name);
     return nullptr;
 }
 
@@ -1472,6 +1940,7 @@ static Function* LogErrorF(const char *Str) { LogErr(ErrorType::SEMANTIC_OTHER,
 //===----------------------------------------------------------------------===//
 
 static void printAST(const std::unique_ptr<ASTnode>& node, const std::string& label) {
+  PhaseTimer Timer(CompilePhase::ASTDump);
   if (!node) {
     fprintf(stderr, "\n%s%s=== %s ===%s\n",
             COLOR_BOLD, COLOR_RED, label.c_str(), COLOR_RESET);
@@ -1495,6 +1964,7 @@ static void printAST(const std::unique_ptr<ASTnode>& node, const std::string& la
 class BinaryExprAST : public ASTnode {
   std::string Op;
   std::unique_ptr<ASTnode> LHS, RHS;
+  const MiniCType *OperandType = nullptr; // both operands are converted to this
 
 public:
   BinaryExprAST(std::string op, std::unique_ptr<ASTnode> lhs, std::unique_ptr<ASTnode> rhs) :
@@ -1505,6 +1975,9 @@ public:
   std::unique_ptr<ASTnode> &getRHS() {return RHS; }
 
   virtual Value* codegen() override;
+  virtual Value* codegenWideIndex(int64_t &Min, int64_t &Max) override;
+  virtual bool sema() override;
+  virtual void checkAssigned(DefiniteAssignment &DA) override;
 
   virtual std::string to_string() const override {
     std::string result = std::string(COLOR_MAGENTA) + "BinaryExpr [" +
@@ -1565,7 +2038,15 @@ public:
   const std::string &getOp() const { return Op; }
   std::unique_ptr<ASTnode> &getOperand() { return Operand; }
 
+  virtual bool getIntConstant(int64_t &C) const override {
+    if (Op != "-" || !Operand || !Operand->getIntConstant(C))
+      return false;
+    C = -C;
+    return true;
+  }
   virtual Value* codegen() override;
+  virtual bool sema() override;
+  virtual void checkAssigned(DefiniteAssignment &DA) override;
 
   virtual std::string to_string() const override {
     std::string result = std::string(COLOR_MAGENTA) + "UnaryExpr" + std::string(COLOR_RESET) + " [" +
@@ -1590,10 +2071,26 @@ public:
   }
 };
 
+// Functions provided by the compiler; a user function of the same name takes precedence.
+// The bulk array builtins (fill, copy, sum, dot) take arrays by name
+enum class BuiltinKind { None, HSum, HMin, HMax, Fill, Copy, Sum, Dot };
+
+// getBuiltin - The builtin a call to Name refers to, or BuiltinKind::None
+static BuiltinKind getBuiltin(const std::string &Name) {
+  static const std::map<std::string, BuiltinKind> Builtins = {
+      {"hsum", BuiltinKind::HSum}, {"hmin", BuiltinKind::HMin}, {"hmax", BuiltinKind::HMax},
+      {"fill", BuiltinKind::Fill}, {"copy", BuiltinKind::Copy}, {"sum", BuiltinKind::Sum},
+      {"dot", BuiltinKind::Dot}};
+  auto It = Builtins.find(Name);
+  return It == Builtins.end() ? BuiltinKind::None : It->second;
+}
+
 // function calls
 class CallExprAST : public ASTnode {
   std::string Callee;
   std::vector<std::unique_ptr<ASTnode>> Args;
+  std::vector<const MiniCType *> ParamTypes; // each argument is converted to its parameter's type
+  BuiltinKind Builtin = BuiltinKind::None;    // set by sema() when the call resolves to a builtin
 
 public:
   CallExprAST(const std::string &callee,
@@ -1604,6 +2101,12 @@ public:
   std::vector<std::unique_ptr<ASTnode>> &getArgs() { return Args; }
 
   virtual Value* codegen() override;
+  virtual bool sema() override;
+  virtual void checkAssigned(DefiniteAssignment &DA) override;
+  bool semaBuiltin();
+  bool semaBulkBuiltin();
+  Value *codegenBuiltin();
+  Value *codegenBulkBuiltin();
 
   virtual std::string to_string() const override {
   std::string result = std::string(COLOR_MAGENTA) + "FunctionCall '" +
@@ -1664,6 +2167,8 @@ public:
   std::unique_ptr<ASTnode> &getRHS() { return RHS; }
 
   virtual Value* codegen() override;
+  virtual bool sema() override;
+  virtual void checkAssigned(DefiniteAssignment &DA) override;
 
   virtual std::string to_string() const override {
   std::string result = std::string(COLOR_MAGENTA) + "AssignmentExpr" + std::string(COLOR_RESET) + "\n";
@@ -1715,6 +2220,39 @@ static std::unique_ptr<ASTnode> ParseExper();
 static std::unique_ptr<ParamAST> ParseParam();
 static std::unique_ptr<DeclAST> ParseLocalDecl();
 static std::vector<std::unique_ptr<ASTnode>> ParseStmtListPrime();
+// Generate a function definition, reusing its optimized body from --function-cache
+static Value *codegenFunctionWithCache(FunctionDeclAST &FD, const TokenRecording &Recording);
+static bool analyzeDecl(ASTnode &Decl);
+static bool analyzeDecl(FunctionPrototypeAST &Proto);
+static void analyzeAssignments(ASTnode &Body);
+
+// getKeywordType - The MiniCType a type keyword names, or nullptr for any other token
+static const MiniCType *getKeywordType(int TokType) {
+  switch (TokType) {
+  case VOID_TOK:
+    return getMiniCType(MiniCType::Void);
+  case INT_TOK:
+    return getMiniCType(MiniCType::Int);
+  case FLOAT_TOK:
+    return getMiniCType(MiniCType::Float);
+  case BOOL_TOK:
+    return getMiniCType(MiniCType::Bool);
+  case INT4_TOK:
+    return getMiniCType(MiniCType::Int, false, {}, 4);
+  case FLOAT4_TOK:
+    return getMiniCType(MiniCType::Float, false, {}, 4);
+  case FLOAT8_TOK:
+    return getMiniCType(MiniCType::Float, false, {}, 8);
+  default:
+    return nullptr;
+  }
+}
+
+// isVarType - True for the keywords that can start a variable or parameter declaration
+static bool isVarType(int TokType) {
+  const MiniCType *Type = getKeywordType(TokType);
+  return Type && Type->Scalar != MiniCType::Void;
+}
 
 // element ::= FLOAT_LIT
 // Parse floating point literal
@@ -1740,24 +2278,32 @@ static std::unique_ptr<ASTnode> ParseBoolExpr() {
   return std::move(Result);
 }
 
+// The *ListPrime rules below are right-recursive in the grammar but parsed
+// with loops, so stack depth does not grow with the length of a list.
+
+// madeNoProgress - True if a list element failed without consuming any token;
+// repeating it would never terminate, so the list ends there
+static bool madeNoProgress(const TOKEN &Before) {
+  return CurTok.type == Before.type && CurTok.lineNo == Before.lineNo &&
+         CurTok.columnNo == Before.columnNo;
+}
+
 // param_list_prime ::= "," param param_list_prime
 //                   |  ε
 static std::vector<std::unique_ptr<ParamAST>> ParseParamListPrime() {
   std::vector<std::unique_ptr<ParamAST>> param_list;
 
-  if (CurTok.type == COMMA) { // more parameters in list
-    getNextToken();           // eat ","
+  while (CurTok.type == COMMA) { // more parameters in list
+    getNextToken();              // eat ","
 
     auto param = ParseParam();
-    if (param) {
-      printf("found param in param_list_prime: %s\n", param->getName().c_str());
-      param_list.emplace_back(std::move(param));
-      auto param_list_prime = ParseParamListPrime();
-      for (unsigned i = 0; i < param_list_prime.size(); i++) {
-        param_list.push_back(std::move(param_list_prime.at(i)));
-      }
-    }
-  } else if (CurTok.type == RPAR) { // FOLLOW(param_list_prime)
+    if (!param)
+      return param_list;
+    DEBUG_PARSER("Found param in param_list_prime: " + param->getName());
+    param_list.emplace_back(std::move(param));
+  }
+
+  if (CurTok.type == RPAR) { // FOLLOW(param_list_prime)
     // expand by param_list_prime ::= ε
     // do nothing
   } else {
@@ -1767,11 +2313,49 @@ static std::vector<std::unique_ptr<ParamAST>> ParseParamListPrime() {
   return param_list;
 }
 
-// param ::= var_type IDENT ["[" INT_LIT "]"]*
+// aligned_attr ::= "aligned" "(" INT_LIT ")" | ε
+// Parse the alignment of an array declaration or array parameter (0 when absent).
+// "aligned" is only special in this position and stays usable as an identifier.
+static bool ParseAlignedAttr(unsigned &Alignment) {
+  Alignment = 0;
+  if (CurTok.type != IDENT || CurTok.getIdentifierStr() != "aligned")
+    return true; // ε production
+  getNextToken(); // eat "aligned"
+
+  if (CurTok.type != LPAR) {
+    LogError(CurTok, "expected '(' after 'aligned'");
+    return false;
+  }
+  getNextToken(); // eat '('
+
+  if (CurTok.type != INT_LIT) {
+    LogError(CurTok, "expected integer literal for array alignment");
+    return false;
+  }
+  if (!isValidArrayAlignment(CurTok.getIntVal())) {
+    LogError(CurTok, "array alignment must be a power of two up to 4096");
+    return false;
+  }
+  Alignment = CurTok.getIntVal();
+  getNextToken(); // eat INT_LIT
+
+  if (CurTok.type != RPAR) {
+    LogError(CurTok, "expected ')' after array alignment");
+    return false;
+  }
+  getNextToken(); // eat ')'
+  return true;
+}
+
+// param ::= var_type IDENT ["[" INT_LIT "]"]* [aligned_attr]
 // Parse function parameter
 static std::unique_ptr<ParamAST> ParseParam() {
-  std::string Type = CurTok.lexeme; // keep track of the type of the param
-  getNextToken();                   // eat the type token
+  const MiniCType *Type = getKeywordType(CurTok.type); // keep track of the type of the param
+  if (!Type || Type->Scalar == MiniCType::Void)
+    return LogError(CurTok, "expected 'int', 'bool', 'float', 'int4', 'float4' or 'float8' in "
+                            "parameter declaration"),
+           nullptr;
+  getNextToken(); // eat the type token
 
   if (CurTok.type == IDENT) { // parameter declaration
     std::string Name = CurTok.getIdentifierStr();
@@ -1797,19 +2381,19 @@ static std::unique_ptr<ParamAST> ParseParam() {
     }
 
     // For array parameters, convert to pointer type representation
-    // int a[10] -> pointer to int (stored as "int*")
-    // int arr[10][5] -> pointer to array of 5 ints (stored as "int*[5]")
+    // int a[10] -> pointer to int (int*)
+    // int arr[10][5] -> pointer to array of 5 ints (int*[5])
+    unsigned Alignment = 0;
     if (!dimensions.empty()) {
-      std::string PtrType = Type + "*";
+      if (!ParseAlignedAttr(Alignment))
+        return nullptr;
       // For multi-dimensional arrays, keep the trailing dimensions
-      for (size_t i = 1; i < dimensions.size(); i++) {
-        PtrType += "[" + std::to_string(dimensions[i]) + "]";
-      }
-      Type = PtrType;
-      DEBUG_PARSER("Parsed array parameter, converted to pointer type: " + Type);
+      std::vector<int> Trailing(dimensions.begin() + 1, dimensions.end());
+      Type = getMiniCType(Type->Scalar, true, Trailing, Type->Lanes);
+      DEBUG_PARSER("Parsed array parameter, converted to pointer type: " + Type->Name);
     }
 
-    return std::make_unique<ParamAST>(Name, Type);
+    return std::make_unique<ParamAST>(Name, Type, Alignment);
   } else {
     return LogError(CurTok, "expected identifier in parameter declaration"), nullptr;
   }
@@ -1841,8 +2425,7 @@ static std::vector<std::unique_ptr<ParamAST>> ParseParams() {
   std::string Type;
   std::string Name = "";
 
-  if (CurTok.type == INT_TOK || CurTok.type == FLOAT_TOK ||
-      CurTok.type == BOOL_TOK) { // FIRST(param_list)
+  if (isVarType(CurTok.type)) { // FIRST(param_list)
 
     auto list = ParseParamList();
     for (unsigned i = 0; i < list.size(); i++) {
@@ -1863,8 +2446,8 @@ static std::vector<std::unique_ptr<ParamAST>> ParseParams() {
   } else {
     LogError(
         CurTok,
-        "expected 'int', 'bool' or 'float' in function declaration or ') in \
-       end of function declaration");
+        "expected 'int', 'bool', 'float', 'int4', 'float4' or 'float8' in function \
+       declaration or ') in end of function declaration");
   }
 
   return param_list;
@@ -2163,74 +2746,91 @@ static std::unique_ptr<ASTnode> ParsePrimaryExpr() {
 //            | primary_expr
 static std::unique_ptr<ASTnode> ParseUnaryExpr() {
 
-  // Case 1: Unary minus
-  if (CurTok.type == MINUS) {
-    getNextToken(); // eat '-'
-    auto operand = ParseUnaryExpr();
-    if (!operand)
-      return nullptr;
-
-    return std::make_unique<UnaryExprAST>("-", std::move(operand));
+  // Case 1-2: Unary minus / not. Collected in a loop so a run of prefix
+  // operators does not recurse once per operator (no allocation without one)
+  std::vector<const char *> prefixOps;
+  while (CurTok.type == MINUS || CurTok.type == NOT) {
+    prefixOps.push_back(CurTok.type == MINUS ? "-" : "!");
+    getNextToken(); // eat '-' or '!'
   }
 
-  // Case 2: Unary not
-  if (CurTok.type == NOT) {
-    getNextToken(); // eat '!'
-    auto operand = ParseUnaryExpr();
-    if (!operand)
-      return nullptr;
-
-    return std::make_unique<UnaryExprAST>("!", std::move(operand));
-  }
+  // Case 3: Primary expression
+  auto operand = ParsePrimaryExpr();
+  if (!operand)
+    return nullptr;
 
-  // Case 3: Primary expression (no unary operator)
-  return ParsePrimaryExpr();
+  // The operator nearest the operand applies first
+  for (auto it = prefixOps.rbegin(); it != prefixOps.rend(); ++it)
+    operand = std::make_unique<UnaryExprAST>(*it, std::move(operand));
+  return operand;
 }
 
-// Generic binary operator parser for left-associative operators
-template<typename ParseHigher>
-static std::unique_ptr<ASTnode> ParseBinaryExpr(ParseHigher parseHigher,
-    std::initializer_list<std::pair<int, const char*>> ops) {
-  auto LHS = parseHigher();
-  if (!LHS) return nullptr;
-
-  while (true) {
-    const char* op = nullptr;
-    for (const auto& [tokType, opStr] : ops) {
-      if (CurTok.type == tokType) { op = opStr; break; }
-    }
-    if (!op) break;
+// Binary operators for precedence climbing. Higher precedence binds tighter;
+// all binary operators in MiniC are left-associative.
+//   ||  <  &&  <  == !=  <  < <= > >=  <  + -  <  * / %
+struct BinOpInfo {
+  const char *Op;
+  int Precedence;
+};
 
-    getNextToken();
-    auto RHS = parseHigher();
-    if (!RHS) return nullptr;
-    LHS = std::make_unique<BinaryExprAST>(op, std::move(LHS), std::move(RHS));
+// getBinOpInfo - The binary operator for a token type, or nullptr
+static const BinOpInfo *getBinOpInfo(int TokType) {
+  static const BinOpInfo Or{"||", 1}, And{"&&", 2}, Eq{"==", 3}, Ne{"!=", 3},
+      Lt{"<", 4}, Le{"<=", 4}, Gt{">", 4}, Ge{">=", 4}, Add{"+", 5}, Sub{"-", 5},
+      Mul{"*", 6}, Div{"/", 6}, Mod{"%", 6};
+
+  switch (TokType) {
+  case OR:      return &Or;
+  case AND:     return &And;
+  case EQ:      return &Eq;
+  case NE:      return &Ne;
+  case LT:      return &Lt;
+  case LE:      return &Le;
+  case GT:      return &Gt;
+  case GE:      return &Ge;
+  case PLUS:    return &Add;
+  case MINUS:   return &Sub;
+  case ASTERIX: return &Mul;
+  case DIV:     return &Div;
+  case MOD:     return &Mod;
+  default:      return nullptr;
   }
-  return LHS;
-}
-
-static std::unique_ptr<ASTnode> ParseMulExpr() {
-  return ParseBinaryExpr(ParseUnaryExpr, {{ASTERIX, "*"}, {DIV, "/"}, {MOD, "%"}});
 }
 
-static std::unique_ptr<ASTnode> ParseAddExpr() {
-  return ParseBinaryExpr(ParseMulExpr, {{PLUS, "+"}, {MINUS, "-"}});
-}
+// ParseBinOpRHS - Precedence climbing: extend LHS with every "op unary_expr"
+// pair whose operator binds at least as tightly as MinPrecedence. Recursion
+// only happens when precedence rises, so depth is bounded by the number of
+// levels rather than the length of the expression.
+static std::unique_ptr<ASTnode> ParseBinOpRHS(int MinPrecedence,
+                                              std::unique_ptr<ASTnode> LHS) {
+  while (true) {
+    const BinOpInfo *Op = getBinOpInfo(CurTok.type);
+    if (!Op || Op->Precedence < MinPrecedence)
+      return LHS;
+    getNextToken(); // eat the operator
 
-static std::unique_ptr<ASTnode> ParseRelExpr() {
-  return ParseBinaryExpr(ParseAddExpr, {{LT, "<"}, {LE, "<="}, {GT, ">"}, {GE, ">="}});
-}
+    auto RHS = ParseUnaryExpr();
+    if (!RHS)
+      return nullptr;
 
-static std::unique_ptr<ASTnode> ParseEqExpr() {
-  return ParseBinaryExpr(ParseRelExpr, {{EQ, "=="}, {NE, "!="}});
-}
+    // A tighter operator after RHS takes RHS as its left operand
+    const BinOpInfo *Next = getBinOpInfo(CurTok.type);
+    if (Next && Next->Precedence > Op->Precedence) {
+      RHS = ParseBinOpRHS(Op->Precedence + 1, std::move(RHS));
+      if (!RHS)
+        return nullptr;
+    }
 
-static std::unique_ptr<ASTnode> ParseAndExpr() {
-  return ParseBinaryExpr(ParseEqExpr, {{AND, "&&"}});
+    LHS = std::make_unique<BinaryExprAST>(Op->Op, std::move(LHS), std::move(RHS));
+  }
 }
 
+// or_expr ::= unary_expr (binary_op unary_expr)*, grouped by operator precedence
 static std::unique_ptr<ASTnode> ParseOrExpr() {
-  return ParseBinaryExpr(ParseAndExpr, {{OR, "||"}});
+  auto LHS = ParseUnaryExpr();
+  if (!LHS)
+    return nullptr;
+  return ParseBinOpRHS(1, std::move(LHS));
 }
 
 // Parse an expression with LL(2) lookahead
@@ -2519,25 +3119,21 @@ static std::vector<std::unique_ptr<ASTnode>> ParseStmtList() {
 //                  |  ε
 static std::vector<std::unique_ptr<ASTnode>> ParseStmtListPrime() {
   std::vector<std::unique_ptr<ASTnode>> stmt_list; // vector of statements
-  if (CurTok.type == NOT || CurTok.type == MINUS || CurTok.type == PLUS ||
-      CurTok.type == LPAR || CurTok.type == IDENT || CurTok.type == BOOL_LIT ||
-      CurTok.type == INT_LIT || CurTok.type == FLOAT_LIT || CurTok.type == SC ||
-      CurTok.type == LBRA || CurTok.type == WHILE || CurTok.type == IF ||
-      CurTok.type == ELSE || CurTok.type == RETURN) { // FIRST(stmt)
+  while (CurTok.type == NOT || CurTok.type == MINUS || CurTok.type == PLUS ||
+         CurTok.type == LPAR || CurTok.type == IDENT || CurTok.type == BOOL_LIT ||
+         CurTok.type == INT_LIT || CurTok.type == FLOAT_LIT || CurTok.type == SC ||
+         CurTok.type == LBRA || CurTok.type == WHILE || CurTok.type == IF ||
+         CurTok.type == ELSE || CurTok.type == RETURN) { // FIRST(stmt)
     // expand by stmt_list ::= stmt stmt_list_prime
+    TOKEN StartTok = CurTok;
     auto stmt = ParseStmt();
     if (stmt) {
       stmt_list.emplace_back(std::move(stmt));
+    } else if (madeNoProgress(StartTok)) {
+      break;
     }
-    auto stmt_prime = ParseStmtListPrime();
-    for (unsigned i = 0; i < stmt_prime.size(); i++) {
-      stmt_list.push_back(std::move(stmt_prime.at(i)));
-    }
-
-  } else if (CurTok.type == RBRA) { // FOLLOW(stmt_list_prime)
-    // expand by stmt_list_prime ::= ε
-    // do nothing
   }
+  // FOLLOW(stmt_list_prime) is '}': expand by stmt_list_prime ::= ε
   return stmt_list; // note stmt_list can be empty as we can have empty blocks,
                     // etc.
 }
@@ -2548,22 +3144,20 @@ static std::vector<std::unique_ptr<DeclAST>> ParseLocalDeclsPrime() {
   std::vector<std::unique_ptr<DeclAST>>
       local_decls_prime; // vector of local decls
 
-  if (CurTok.type == INT_TOK || CurTok.type == FLOAT_TOK ||
-      CurTok.type == BOOL_TOK) { // FIRST(local_decl)
+  while (isVarType(CurTok.type)) { // FIRST(local_decl)
+    // local_decl always consumes the type token
     auto local_decl = ParseLocalDecl();
     if (local_decl) {
       local_decls_prime.emplace_back(std::move(local_decl));
     }
-    auto prime = ParseLocalDeclsPrime();
-    for (unsigned i = 0; i < prime.size(); i++) {
-      local_decls_prime.push_back(std::move(prime.at(i)));
-    }
-  } else if (CurTok.type == MINUS || CurTok.type == NOT ||
-             CurTok.type == LPAR || CurTok.type == IDENT ||
-             CurTok.type == INT_LIT || CurTok.type == FLOAT_LIT ||
-             CurTok.type == BOOL_LIT || CurTok.type == SC ||
-             CurTok.type == LBRA || CurTok.type == IF || CurTok.type == WHILE ||
-             CurTok.type == RETURN || CurTok.type == RBRA) { // FOLLOW(local_decls_prime) - added RBRA for empty blocks
+  }
+
+  if (CurTok.type == MINUS || CurTok.type == NOT ||
+      CurTok.type == LPAR || CurTok.type == IDENT ||
+      CurTok.type == INT_LIT || CurTok.type == FLOAT_LIT ||
+      CurTok.type == BOOL_LIT || CurTok.type == SC ||
+      CurTok.type == LBRA || CurTok.type == IF || CurTok.type == WHILE ||
+      CurTok.type == RETURN || CurTok.type == RBRA) { // FOLLOW(local_decls_prime) - added RBRA for empty blocks
     // expand by local_decls_prime ::=  ε
     // do nothing;
   } else {
@@ -2581,18 +3175,18 @@ static std::vector<std::unique_ptr<DeclAST>> ParseLocalDeclsPrime() {
 // var_type ::= "int"
 //           |  "float"
 //           |  "bool"
+//           |  "int4" | "float4" | "float8"
 static std::unique_ptr<DeclAST> ParseLocalDecl() {
   TOKEN PrevTok;
-  std::string Type;
+  const MiniCType *Type;
   std::string Name = "";
 
-  if (CurTok.type == INT_TOK || CurTok.type == FLOAT_TOK ||
-      CurTok.type == BOOL_TOK) { // FIRST(var_type)
+  if (isVarType(CurTok.type)) { // FIRST(var_type)
     PrevTok = CurTok;
     getNextToken(); // eat 'int' or 'float or 'bool'
 
     if (CurTok.type == IDENT) {
-      Type = PrevTok.lexeme;
+      Type = getKeywordType(PrevTok.type);
       Name = CurTok.getIdentifierStr(); // save the identifier name
       auto ident = std::make_unique<VariableASTnode>(CurTok, Name);
 
@@ -2637,6 +3231,11 @@ static std::unique_ptr<DeclAST> ParseLocalDecl() {
           return nullptr;
         }
 
+        unsigned Alignment;
+        if (!ParseAlignedAttr(Alignment)) {
+          return nullptr;
+        }
+
         if (CurTok.type != SC) {
           LogError(CurTok, "expected ';' after local array declaration");
           return nullptr;
@@ -2645,7 +3244,7 @@ static std::unique_ptr<DeclAST> ParseLocalDecl() {
 
         fprintf(stderr, "Parsed a local array declaration\n");
         std::unique_ptr<DeclAST> arrayDecl = std::make_unique<ArrayDeclAST>(
-            Name, Type, std::move(dimensions), false);
+            Name, Type, dimensions, false, false, Alignment);
         return arrayDecl;
       } else {
         LogError(CurTok, "Expected ';' or '[' after identifier in local declaration");
@@ -2663,8 +3262,7 @@ static std::unique_ptr<DeclAST> ParseLocalDecl() {
 static std::vector<std::unique_ptr<DeclAST>> ParseLocalDecls() {
   std::vector<std::unique_ptr<DeclAST>> local_decls; // vector of local decls
 
-  if (CurTok.type == INT_TOK || CurTok.type == FLOAT_TOK ||
-      CurTok.type == BOOL_TOK) { // FIRST(local_decl)
+  if (isVarType(CurTok.type)) { // FIRST(local_decl)
 
     auto local_decl = ParseLocalDecl();
     if (local_decl) {
@@ -2715,16 +3313,31 @@ static std::unique_ptr<ASTnode> ParseBlock() {
                                     std::move(stmt_list));
 }
 
-// decl ::= var_decl
-//       |  fun_decl
+// decl ::= ["static"] var_decl
+//       |  ["static"] fun_decl
 static std::unique_ptr<ASTnode> ParseDecl() {
   std::string IdName;
   std::vector<std::unique_ptr<ParamAST>> param_list;
 
+  // Trace span named after the declared identifier (type token, or "static" first)
+  TimeTraceScope TraceScope("ParseDecl", [&] {
+    return peekToken(CurTok.type == STATIC ? 1 : 0).lexeme;
+  });
+
+  // Function definitions are keyed on their token text by the function cache
+  std::unique_ptr<TokenRecordingScope> RecordingScope;
+  if (!Opts.FunctionCacheDir.empty())
+    RecordingScope = std::make_unique<TokenRecordingScope>();
+
+  bool IsStatic = false;
+  if (CurTok.type == STATIC) {
+    IsStatic = true;
+    getNextToken(); // eat "static"
+  }
+
   TOKEN PrevTok = CurTok; // to keep track of the type token
 
-  if (CurTok.type == VOID_TOK || CurTok.type == INT_TOK ||
-      CurTok.type == FLOAT_TOK || CurTok.type == BOOL_TOK) {
+  if (CurTok.type == VOID_TOK || isVarType(CurTok.type)) {
     getNextToken(); // eat the VOID_TOK, INT_TOK, BOOL_TOK or FLOAT_TOK
 
     IdName = CurTok.getIdentifierStr(); // save the identifier name
@@ -2743,9 +3356,10 @@ static std::unique_ptr<ASTnode> ParseDecl() {
         if (PrevTok.type != VOID_TOK) {
           // Declare as ASTnode pointer
           std::unique_ptr<ASTnode> globVar = std::make_unique<GlobVarDeclAST>(
-              std::move(ident), PrevTok.lexeme);
+              std::move(ident), getKeywordType(PrevTok.type), IsStatic);
 
-          globVar->codegen();
+          if (analyzeDecl(*globVar))
+            globVar->codegen();
 
           printAST(globVar, "Global Variable: " + IdName);
           return globVar;
@@ -2782,6 +3396,11 @@ static std::unique_ptr<ASTnode> ParseDecl() {
           return nullptr;
         }
 
+        unsigned Alignment;
+        if (!ParseAlignedAttr(Alignment)) {
+          return nullptr;
+        }
+
         if (CurTok.type != SC) {
           return LogError(CurTok, "expected ';' after array declaration"), nullptr;
         }
@@ -2791,9 +3410,10 @@ static std::unique_ptr<ASTnode> ParseDecl() {
 
         if (PrevTok.type != VOID_TOK) {
           std::unique_ptr<ASTnode> arrayDecl = std::make_unique<ArrayDeclAST>(
-              IdName, PrevTok.lexeme, std::move(dimensions), true);
+              IdName, getKeywordType(PrevTok.type), dimensions, true, IsStatic, Alignment);
 
-          arrayDecl->codegen();
+          if (analyzeDecl(*arrayDecl))
+            arrayDecl->codegen();
 
           printAST(arrayDecl, "Global Array: " + IdName);
           return arrayDecl;
@@ -2823,12 +3443,13 @@ static std::unique_ptr<ASTnode> ParseDecl() {
           fprintf(stderr, "Parsed a function forward declaration (prototype)\n");
 
           auto Proto = std::make_unique<FunctionPrototypeAST>(
-              IdName, PrevTok.lexeme, std::move(P));
+              IdName, getKeywordType(PrevTok.type), std::move(P), IsStatic);
           std::unique_ptr<ASTnode> funcDecl = std::make_unique<FunctionDeclAST>(
               std::move(Proto), nullptr);
 
           // For prototypes, just register the function without generating full body
-          funcDecl->codegen();
+          if (analyzeDecl(*funcDecl))
+            funcDecl->codegen();
           printAST(funcDecl, "Function Prototype: " + IdName);
           return funcDecl;
 
@@ -2847,11 +3468,17 @@ static std::unique_ptr<ASTnode> ParseDecl() {
           fprintf(stderr, "Parsed a function declaration\n");
 
           auto Proto = std::make_unique<FunctionPrototypeAST>(
-              IdName, PrevTok.lexeme, std::move(P));
+              IdName, getKeywordType(PrevTok.type), std::move(P), IsStatic);
           std::unique_ptr<ASTnode> funcDecl = std::make_unique<FunctionDeclAST>(
               std::move(Proto), std::move(B));
 
-          funcDecl->codegen();
+          if (analyzeDecl(*funcDecl)) {
+            if (RecordingScope)
+              codegenFunctionWithCache(static_cast<FunctionDeclAST &>(*funcDecl),
+                                       RecordingScope->Recording);
+            else
+              funcDecl->codegen();
+          }
           printAST(funcDecl, "Function: " + IdName);
           return funcDecl;
 
@@ -2873,14 +3500,17 @@ static std::unique_ptr<ASTnode> ParseDecl() {
 // decl_list_prime ::= decl decl_list_prime
 //                  |  ε
 static void ParseDeclListPrime() {
-  if (CurTok.type == VOID_TOK || CurTok.type == INT_TOK ||
-      CurTok.type == FLOAT_TOK || CurTok.type == BOOL_TOK) { // FIRST(decl)
-
+  while (CurTok.type == VOID_TOK || isVarType(CurTok.type) ||
+         CurTok.type == STATIC) { // FIRST(decl)
+    TOKEN StartTok = CurTok;
     if (auto decl = ParseDecl()) {
       fprintf(stderr, "Parsed a top-level variable or function declaration\n");
+    } else if (madeNoProgress(StartTok)) {
+      return;
     }
-    ParseDeclListPrime();
-  } else if (CurTok.type == EOF_TOK) { // FOLLOW(decl_list_prime)
+  }
+
+  if (CurTok.type == EOF_TOK) { // FOLLOW(decl_list_prime)
     // expand by decl_list_prime ::= ε
     // do nothing
   } else { // syntax error
@@ -2905,8 +3535,7 @@ static std::unique_ptr<FunctionPrototypeAST> ParseExtern() {
   if (CurTok.type == EXTERN) {
     getNextToken(); // eat the EXTERN
 
-    if (CurTok.type == VOID_TOK || CurTok.type == INT_TOK ||
-        CurTok.type == FLOAT_TOK || CurTok.type == BOOL_TOK) {
+    if (CurTok.type == VOID_TOK || isVarType(CurTok.type)) {
 
       PrevTok = CurTok; // to keep track of the type token
       getNextToken();   // eat the VOID_TOK, INT_TOK, BOOL_TOK or FLOAT_TOK
@@ -2936,7 +3565,7 @@ static std::unique_ptr<FunctionPrototypeAST> ParseExtern() {
           if (CurTok.type == SC) {
             getNextToken(); // eat ";"
             auto Proto = std::make_unique<FunctionPrototypeAST>(
-                IdName, PrevTok.lexeme, std::move(P));
+                IdName, getKeywordType(PrevTok.type), std::move(P));
             return Proto;
           } else
             return LogErrorP(
@@ -2959,12 +3588,12 @@ static std::unique_ptr<FunctionPrototypeAST> ParseExtern() {
 //                   |  ε
 
 static void ParseExternListPrime() {
-  if (CurTok.type == EXTERN) { // FIRST(extern)
+  while (CurTok.type == EXTERN) { // FIRST(extern); ParseExtern always eats it
     if (auto Extern = ParseExtern()) {
       fprintf(stderr, "Parsed a top-level external function declaration -- 2\n");
 
       // Generate code for external function declaration
-      if (Function* ExternF = Extern->codegen()) {
+      if (analyzeDecl(*Extern) && Extern->codegen()) {
           fprintf(stderr, "Generated code for external function: %s\n",
                   Extern->getName().c_str());
       } else {
@@ -2972,10 +3601,10 @@ static void ParseExternListPrime() {
                   Extern->getName().c_str());
       }
     }
-    ParseExternListPrime();
-  } else if (CurTok.type == VOID_TOK || CurTok.type == INT_TOK ||
-             CurTok.type == FLOAT_TOK ||
-             CurTok.type == BOOL_TOK) { // FOLLOW(extern_list_prime)
+  }
+
+  if (CurTok.type == VOID_TOK || isVarType(CurTok.type) ||
+      CurTok.type == STATIC) { // FOLLOW(extern_list_prime)
     // expand by decl_list_prime ::= ε
     // do nothing
   } else { // syntax error
@@ -2990,7 +3619,7 @@ static void ParseExternList() {
     fprintf(stderr, "Parsed a top-level external function declaration -- 1\n");
 
     // Generate code for external function declaration
-    if (Function* ExternF = Extern->codegen()) {
+    if (analyzeDecl(*Extern) && Extern->codegen()) {
         fprintf(stderr, "Generated code for external function: %s\n",
                 Extern->getName().c_str());
     } else {
@@ -3015,857 +3644,1498 @@ static void parser() {
     return;
 }
 
-//===----------------------------------------------------------------------===//
-// Code Generation
-//===----------------------------------------------------------------------===//
-
-//===----------------------------------------------------------------------===//
-// Symbol Tables and Helper Functions
-//===----------------------------------------------------------------------===//
-
-// getTypeFromString - Convert MiniC type string to LLVM Type*
-
 //==============================================================================
-// HELPER FUNCTIONS
-// Utility functions for type conversion, symbol tables, and code generation
+// SEMANTIC ANALYSIS
+// Resolves the MiniCType of every expression and checks scopes, conversions
+// and signatures before any IR is generated. Nodes record what codegen needs
+// (their own type and the types operands convert to), so codegen only lowers.
 //==============================================================================
 
-static Type* getTypeFromString(const std::string& typeStr) {
-    if (typeStr == "int") return Type::getInt32Ty(TheContext);
-    if (typeStr == "float") return Type::getFloatTy(TheContext);
-    if (typeStr == "bool") return Type::getInt1Ty(TheContext);
-    if (typeStr == "void") return Type::getVoidTy(TheContext);
-    if (typeStr.find('*') != std::string::npos) return PointerType::get(TheContext, 0);
+// A function as the semantic pass knows it
+struct FunctionSignature {
+    const MiniCType* ReturnType;
+    std::vector<const MiniCType*> ParamTypes;
+    bool Defined;  // a body has been seen
+};
 
-    fprintf(stderr, "Error: Unknown type '%s'\n", typeStr.c_str());
-    return nullptr;
-}
+static std::map<std::string, const MiniCType*> LocalTypes;   // variables in scope in the current function
+static std::map<std::string, const MiniCType*> GlobalTypes;  // global variables and arrays
+static std::map<std::string, FunctionSignature> FunctionSignatures;
+static const FunctionSignature* CurrentSignature = nullptr;  // function whose body is analyzed
 
-// CreateEntryBlockAlloca - Create alloca in entry block of function
-// From LLVM Tutorial Chapter 7
-static AllocaInst* CreateEntryBlockAlloca(Function *TheFunction,
-                                          const std::string &VarName,
-                                          Type* VarType) {
-    IRBuilder<> TmpB(&TheFunction->getEntryBlock(),
-                     TheFunction->getEntryBlock().begin());
-    return TmpB.CreateAlloca(VarType, nullptr, VarName);
+// registerVariable - Register a variable in the symbol table with type info
+static void registerVariable(const std::string& varName, const MiniCType* type,
+                             bool isGlobal = false, int line = -1, int col = -1) {
+    SymbolTypeTable[varName] = TypeInfo(type, isGlobal, line, col);
+    SymbolNameIndex.insert(varName);
+    DEBUG_VERBOSE("Registered variable '" + varName + "' with type '" + type->Name +
+                 "' (global: " + (isGlobal ? "yes" : "no") + ")");
 }
 
-// Extract element type from array parameter type string
-static Type* getElementTypeFromParamType(const std::string& paramTypeStr) {
-    for (const auto& [name, type] : {std::pair{"float", Type::getFloatTy(TheContext)},
-                                      {"int", Type::getInt32Ty(TheContext)},
-                                      {"bool", Type::getInt1Ty(TheContext)}}) {
-        if (paramTypeStr.find(name) != std::string::npos) return type;
+// Check if variable is in scope and return its type. Suggest similar variables if not found.
+static const MiniCType* checkVariableInScope(const std::string& varName, int line = -1, int col = -1) {
+    DEBUG_CODEGEN("Checking scope for variable: " + varName);
+
+    // Check local scope first
+    auto It = LocalTypes.find(varName);
+    if (It != LocalTypes.end()) {
+        DEBUG_CODEGEN("  Found in local scope: " + It->second->Name);
+        return It->second;
     }
-    return Type::getInt32Ty(TheContext); // Default to int
-}
 
-// extractInnerDimensionFromParamType - Extract inner dimension from 2D array parameter
-// For "float*[10]" returns 10, for "int*[5]" returns 5
-// Returns -1 if no dimension found (1D array parameter)
-static int extractInnerDimensionFromParamType(const std::string& paramTypeStr) {
-    size_t lbracket = paramTypeStr.find('[');
-    size_t rbracket = paramTypeStr.find(']');
+    // Check global scope
+    It = GlobalTypes.find(varName);
+    if (It != GlobalTypes.end()) {
+        DEBUG_CODEGEN("  Found in global scope: " + It->second->Name);
+        return It->second;
+    }
 
-    if (lbracket != std::string::npos && rbracket != std::string::npos) {
-        std::string dimStr = paramTypeStr.substr(lbracket + 1, rbracket - lbracket - 1);
-        try {
-            return std::stoi(dimStr);
-        } catch (...) {
-            return -1;
-        }
+    // Variable not found - let's suggest similar names
+    DEBUG_CODEGEN("  ERROR: Variable not found in any scope");
+
+    std::string suggestion = findClosestMatch(varName, SymbolNameIndex);
+
+    std::string msg = "Undefined variable '" + varName + "'";
+    if (CurrentContext.currentFunction.empty()) {
+        msg += " in global scope";
+    } else {
+        msg += " in function '" + CurrentContext.currentFunction + "'";
     }
-    return -1;
+
+    LogCompilerError(ErrorType::SEMANTIC_SCOPE, msg, line, col, "", suggestion);
+    DUMP_SYMBOL_TABLE();
+    return nullptr;
 }
 
-// getArrayTypeForParam - Create the proper array type for a 2D array parameter
-// For "float*[10]" returns [10 x float]
-// For "int*[5]" returns [5 x i32]
-static Type* getArrayTypeForParam(const std::string& paramTypeStr) {
-    Type* elementType = getElementTypeFromParamType(paramTypeStr);
-    int innerDim = extractInnerDimensionFromParamType(paramTypeStr);
+// checkFunctionExists - Check if function is declared
+static const FunctionSignature* checkFunctionExists(const std::string& funcName, int line = -1, int col = -1) {
+    DEBUG_CODEGEN("Checking function: " + funcName);
+
+    auto It = FunctionSignatures.find(funcName);
+    if (It == FunctionSignatures.end()) {
+        DEBUG_CODEGEN("  ERROR: Function not found");
+        std::string msg = "Call to undefined function '" + funcName + "'";
+
+        // Provide suggestions for similar function names: a close spelling,
+        // else a function sharing the first three characters
+        std::string suggestion;
+        std::string fnName = findClosestMatch(funcName, FunctionNameIndex);
+        if (fnName.empty())
+            fnName = FunctionNameIndex.withPrefix(funcName.substr(0, std::min((size_t)3, funcName.length())));
+        if (!fnName.empty())
+            suggestion = "\n  Did you mean '" + fnName + "'?";
 
-    if (innerDim > 0) {
-        return llvm::ArrayType::get(elementType, innerDim);
+        LogCompilerError(ErrorType::SEMANTIC_SCOPE, msg + suggestion, line, col);
+        return nullptr;
     }
-    return elementType;
+
+    return &It->second;
 }
 
-//===----------------------------------------------------------------------===//
-// Code Generation - AST Node Implementations
-//===----------------------------------------------------------------------===//
+// signatureName - "int(float, int*[5])" for messages about function types
+static std::string signatureName(const MiniCType* ReturnType,
+                                 const std::vector<const MiniCType*>& ParamTypes) {
+    std::string Name = ReturnType->Name + "(";
+    for (size_t i = 0; i < ParamTypes.size(); i++)
+        Name += (i ? ", " : "") + ParamTypes[i]->Name;
+    return Name + ")";
+}
 
-// IntASTnode::codegen - Generate LLVM IR for integer literals
+// isNumeric - int, float and bool values convert into one another
+static bool isNumeric(const MiniCType* T) {
+    return T && T->isScalar() && T->Scalar != MiniCType::Void;
+}
 
-//==============================================================================
-// CODE GENERATION
-// LLVM IR generation for all AST nodes
-// Uses LLVM IRBuilder to generate SSA form intermediate representation
-//==============================================================================
-
-Value* IntASTnode::codegen() {
-    DEBUG_CODEGEN("Generating integer literal: " + std::to_string(Val));
-    return ConstantInt::get(Type::getInt32Ty(TheContext), APInt(32, Val, true));
+// isArithmetic - Types the arithmetic operators apply to: numeric scalars and vectors
+static bool isArithmetic(const MiniCType* T) {
+    return isNumeric(T) || (T && T->isVector());
 }
 
-// FloatASTnode::codegen - Generate LLVM IR for float literals
-Value* FloatASTnode::codegen() {
-    DEBUG_CODEGEN("Generating float literal: " + std::to_string(Val));
-    return ConstantFP::get(Type::getFloatTy(TheContext), APFloat((float)Val));
-}
-
-// BoolASTnode::codegen - Generate LLVM IR for boolean literals
-Value* BoolASTnode::codegen() {
-    DEBUG_CODEGEN("Generating boolean literal: " + std::string(Bool ? "true" : "false"));
-    return ConstantInt::get(Type::getInt1Ty(TheContext), APInt(1, Bool ? 1 : 0, false));
+// isNarrowing - Per MiniC spec: widening is bool→int→float, narrowing is reverse
+static bool isNarrowing(const MiniCType* From, const MiniCType* To) {
+    if (!isNumeric(From) || !isNumeric(To)) return false;
+    if (From->Scalar == MiniCType::Float)
+        return To->Scalar == MiniCType::Int || To->Scalar == MiniCType::Bool;
+    return From->Scalar == MiniCType::Int && To->Scalar == MiniCType::Bool;
 }
 
-// Check if variable is in scope and return its type. Suggest similar variables if not found.
-static TypeInfo* checkVariableInScope(const std::string& varName, int line = -1, int col = -1) {
-    DEBUG_CODEGEN("Checking scope for variable: " + varName);
-
-    // Check local scope first
-    if (NamedValues.find(varName) != NamedValues.end()) {
-        TypeInfo* info = getTypeInfo(varName);
-        if (info) {
-            DEBUG_CODEGEN("  Found in local scope: " + info->typeName);
-            return info;
-        }
+// checkConversion - Whether a From value may be used where a To is expected.
+// Narrowing is only implicit in conditions and logical operators
+static bool checkConversion(const MiniCType* From, const MiniCType* To, bool allowNarrowing,
+                            const std::string& context = "") {
+    if (From == To) return true;
+
+    // A scalar converts to a vector by converting to the lane type and splatting
+    const MiniCType* Target = To->isVector() ? getMiniCType(To->Scalar) : To;
+    bool Narrowing = isNarrowing(From, Target);
+    if (isNumeric(From) && isNumeric(Target) && (allowNarrowing || !Narrowing)) {
+        DEBUG_VERBOSE("  Type conversion needed: " + From->Name + " -> " + To->Name);
+        return true;
     }
 
-    // Check global scope
-    if (GlobalValues.find(varName) != GlobalValues.end()) {
-        TypeInfo* info = getTypeInfo(varName);
-        if (info) {
-            DEBUG_CODEGEN("  Found in global scope: " + info->typeName);
-            return info;
-        }
+    std::string msg = Narrowing ? "Narrowing conversion not allowed" : "Cannot convert between types";
+    if (!context.empty()) {
+        msg += " in " + context;
     }
+    msg += "\n  From: " + From->Name + "\n  To: " + To->Name;
+    LogCompilerError(ErrorType::SEMANTIC_TYPE, msg);
+    return false;
+}
 
-    // Variable not found - let's suggest similar names
-    DEBUG_CODEGEN("  ERROR: Variable not found in any scope");
+// commonType - Type both operands of a binary operator are promoted to, or nullptr
+static const MiniCType* commonType(const MiniCType* L, const MiniCType* R) {
+    if (L == R) return L;
+    if (L && R && (L->isVector() || R->isVector())) {
+        // Vector with scalar: the scalar is splatted if it converts to the lane type
+        const MiniCType* Vec = L->isVector() ? L : R;
+        const MiniCType* Other = Vec == L ? R : L;
+        bool Splat = isNumeric(Other) && !isNarrowing(Other, getMiniCType(Vec->Scalar));
+        return Splat ? Vec : nullptr;
+    }
+    if (!isNumeric(L) || !isNumeric(R)) return nullptr;
+    if (L->Scalar == MiniCType::Float || R->Scalar == MiniCType::Float)
+        return getMiniCType(MiniCType::Float);
+    return getMiniCType(MiniCType::Int);  // int with bool
+}
 
-    // Collect all available variable names for suggestion
-    std::vector<std::string> availableVars;
-    for (const auto& pair : SymbolTypeTable) {
-        availableVars.push_back(pair.first);
-    }
+// analyzeDecl - Run the semantic pass over a top-level declaration. True when it
+// may be lowered to IR: it is valid and nothing before it failed either
+static bool analyzeDecl(ASTnode& Decl) {
+    PhaseTimer Timer(CompilePhase::Semantic);
+    return Decl.sema() && !HasErrors;
+}
 
-    std::string suggestion = findClosestMatch(varName, availableVars);
+static bool analyzeDecl(FunctionPrototypeAST& Proto) {
+    PhaseTimer Timer(CompilePhase::Semantic);
+    return Proto.sema() && !HasErrors;
+}
 
-    std::string msg = "Undefined variable '" + varName + "'";
-    if (CurrentContext.currentFunction.empty()) {
-        msg += " in global scope";
-    } else {
-        msg += " in function '" + CurrentContext.currentFunction + "'";
-    }
+bool IntASTnode::sema() {
+    ResolvedType = getMiniCType(MiniCType::Int);
+    return true;
+}
 
-    LogCompilerError(ErrorType::SEMANTIC_SCOPE, msg, line, col, "", suggestion);
-    return nullptr;
+bool FloatASTnode::sema() {
+    ResolvedType = getMiniCType(MiniCType::Float);
+    return true;
 }
 
-// VariableASTnode::codegen - Generate LLVM IR for variable references
-Value* VariableASTnode::codegen() {
-    DEBUG_CODEGEN("Loading variable: " + Name);
+bool BoolASTnode::sema() {
+    ResolvedType = getMiniCType(MiniCType::Bool);
+    return true;
+}
 
-    // Check scope and get type information
-    TypeInfo* typeInfo = checkVariableInScope(Name, Tok.lineNo, Tok.columnNo);
-    if (!typeInfo) {
-        // Error already logged by checkVariableInScope
-        DUMP_SYMBOL_TABLE();
-        return nullptr;
+// VariableASTnode::sema - A variable read; a whole array is not a value
+bool VariableASTnode::sema() {
+    const MiniCType* VarType = checkVariableInScope(Name, Tok.lineNo, Tok.columnNo);
+    if (!VarType)
+        return false;
+
+    if (VarType->isArray()) {
+        bool IsLocal = LocalTypes.count(Name);
+        LogCompilerError(ErrorType::SEMANTIC_TYPE,
+                       std::string(IsLocal ? "Type mismatch for variable '" : "Type mismatch for global variable '") +
+                       Name + "'",
+                       Tok.lineNo, Tok.columnNo);
+        return false;
     }
 
-    // Try local scope first
-    AllocaInst* V = NamedValues[Name];
-    if (V) {
-        DEBUG_CODEGEN("  Found in local scope: " + getTypeName(V->getAllocatedType()));
-        DEBUG_CODEGEN("  Type from symbol table: " + typeInfo->typeName);
+    ResolvedType = VarType;
+    return true;
+}
 
-        // Verify type consistency
-        Type* expectedType = getTypeFromString(typeInfo->typeName);
-        if (V->getAllocatedType() != expectedType) {
-            LogCompilerError(ErrorType::SEMANTIC_TYPE,
-                           "Type mismatch for variable '" + Name + "'",
-                           Tok.lineNo, Tok.columnNo);
-            return nullptr;
-        }
+// BinaryExprAST::sema - Arithmetic yields the promoted operand type, comparisons
+// and logical operators yield bool
+bool BinaryExprAST::sema() {
+    // Both sides are analyzed so that errors in either get reported
+    bool LOk = LHS->sema();
+    bool ROk = RHS->sema();
+    if (!LOk || !ROk)
+        return false;
 
-        return Builder.CreateLoad(V->getAllocatedType(), V, Name.c_str());
-    }
+    const MiniCType* LTy = LHS->getResolvedType();
+    const MiniCType* RTy = RHS->getResolvedType();
+    const MiniCType* BoolTy = getMiniCType(MiniCType::Bool);
 
-    // Try global scope
-    GlobalVariable* GV = GlobalValues[Name];
-    if (GV) {
-        DEBUG_CODEGEN("  Found in global scope: " + getTypeName(GV->getValueType()));
-        DEBUG_CODEGEN("  Type from symbol table: " + typeInfo->typeName);
+    if (Op == "&&" || Op == "||") {
+        // Logical operators allow narrowing (like conditionals) per MiniC spec
+        std::string Name = Op == "&&" ? "logical AND" : "logical OR";
+        bool LConv = checkConversion(LTy, BoolTy, true, Name + " left operand");
+        bool RConv = checkConversion(RTy, BoolTy, true, Name + " right operand");
+        if (!LConv || !RConv)
+            return false;
+        OperandType = ResolvedType = BoolTy;
+        return true;
+    }
 
-        // Verify type consistency
-        Type* expectedType = getTypeFromString(typeInfo->typeName);
-        if (GV->getValueType() != expectedType) {
-            LogCompilerError(ErrorType::SEMANTIC_TYPE,
-                           "Type mismatch for global variable '" + Name + "'",
-                           Tok.lineNo, Tok.columnNo);
-            return nullptr;
-        }
+    bool Arithmetic = Op == "+" || Op == "-" || Op == "*" || Op == "/" || Op == "%";
+    bool Comparison = Op == "<" || Op == "<=" || Op == ">" || Op == ">=" || Op == "==" || Op == "!=";
+    if (!Arithmetic && !Comparison) {
+        LogCompilerError(ErrorType::SEMANTIC_OTHER, "Unknown binary operator: '" + Op + "'");
+        return false;
+    }
 
-        return Builder.CreateLoad(GV->getValueType(), GV, Name.c_str());
+    // Validate arithmetic operators require numeric types (not bool)
+    if (Arithmetic && (LTy == BoolTy || RTy == BoolTy)) {
+        LogCompilerError(ErrorType::SEMANTIC_TYPE,
+                       "Arithmetic operator '" + Op + "' requires numeric operands (int or float), not bool",
+                       -1, -1, "LHS: " + LTy->Name + ", RHS: " + RTy->Name);
+        return false;
     }
 
-    // Should never reach here if checkVariableInScope worked correctly
-    DEBUG_CODEGEN("  INTERNAL ERROR: Variable found in symbol table but not in scope maps");
-    DUMP_SYMBOL_TABLE();
-    return nullptr;
-}
+    OperandType = commonType(LTy, RTy);
+    const MiniCType* Shown = OperandType ? OperandType : LTy;
 
-//===----------------------------------------------------------------------===//
-// Type Conversion Helpers
-//===----------------------------------------------------------------------===//
+    if (Op == "%" && (!isArithmetic(OperandType) || OperandType->Scalar != MiniCType::Int)) {
+        LogCompilerError(ErrorType::SEMANTIC_TYPE, "Modulo operator '%' requires integer operands",
+                       -1, -1, "Got: " + Shown->Name);
+        return false;
+    }
 
-//===----------------------------------------------------------------------===//
-// Enhanced Type System
-//===----------------------------------------------------------------------===//
+    // Vectors support arithmetic lane-wise but have no ordering or equality
+    if (Arithmetic ? !isArithmetic(OperandType) : !isNumeric(OperandType)) {
+        LogCompilerError(ErrorType::SEMANTIC_TYPE, "Invalid operand types for operator '" + Op + "'", -1, -1,
+                       Arithmetic ? "LHS: " + LTy->Name + ", RHS: " + RTy->Name : "Got: " + Shown->Name);
+        return false;
+    }
 
-// registerVariable - Register a variable in the symbol table with type info
-static void registerVariable(const std::string& varName, const std::string& typeName,
-                             bool isGlobal = false, int line = -1, int col = -1) {
-    SymbolTypeTable[varName] = TypeInfo(typeName, isGlobal, line, col);
-    DEBUG_VERBOSE("Registered variable '" + varName + "' with type '" + typeName +
-                 "' (global: " + (isGlobal ? "yes" : "no") + ")");
+    ResolvedType = Arithmetic ? OperandType : BoolTy;
+    return true;
 }
 
-// checkFunctionExists - Check if function is declared
-static Function* checkFunctionExists(const std::string& funcName, int line = -1, int col = -1) {
-    DEBUG_CODEGEN("Checking function: " + funcName);
+// UnaryExprAST::sema - Negation keeps the operand type (negating vectors lane-wise), '!' yields bool
+bool UnaryExprAST::sema() {
+    if (!Operand->sema())
+        return false;
 
-    Function* F = TheModule->getFunction(funcName);
-    if (!F) {
-        DEBUG_CODEGEN("  ERROR: Function not found");
-        std::string msg = "Call to undefined function '" + funcName + "'";
+    const MiniCType* OpType = Operand->getResolvedType();
 
-        // Provide suggestions for similar function names
-        std::string suggestion;
-        for (auto& Fn : TheModule->functions()) {
-            std::string fnName = Fn.getName().str();
-            if (fnName.find(funcName.substr(0, std::min((size_t)3, funcName.length()))) != std::string::npos) {
-                suggestion = "\n  Did you mean '" + fnName + "'?";
-                break;
-            }
+    if (Op == "-") {
+        if (!isArithmetic(OpType) || OpType->Scalar == MiniCType::Bool) {
+            LogCompilerError(ErrorType::SEMANTIC_TYPE, "Unary operator '-' requires numeric operand",
+                           -1, -1, "Got: " + OpType->Name);
+            return false;
         }
+        ResolvedType = OpType;
+        return true;
+    }
 
-        LogCompilerError(ErrorType::SEMANTIC_SCOPE, msg + suggestion, line, col);
-        return nullptr;
+    if (Op == "!") {
+        // Logical NOT allows narrowing (like conditionals) per MiniC spec
+        ResolvedType = getMiniCType(MiniCType::Bool);
+        if (!checkConversion(OpType, ResolvedType, true, "logical NOT operand")) {
+            LogErrorV("Failed to convert operand to boolean for '!' operator");
+            return false;
+        }
+        return true;
     }
 
-    DEBUG_CODEGEN("  Function found: " + getTypeName(F->getFunctionType()));
-    return F;
+    LogCompilerError(ErrorType::SEMANTIC_OTHER, "Unknown unary operator: '" + Op + "'");
+    return false;
 }
 
-// getValueType - Get the LLVM type of a Value
-static Type* getValueType(Value* V) {
-    if (!V) return nullptr;
-    return V->getType();
-}
+// AssignmentExprAST::sema - The value converts to the variable's type without narrowing
+bool AssignmentExprAST::sema() {
+    if (!RHS->sema())
+        return false;
 
-// isNarrowingConversion - Check if conversion from From to To is narrowing
-// Per MiniC spec: widening is bool→int→float, narrowing is reverse
-static bool isNarrowingConversion(Type* From, Type* To) {
-    if (!From || !To) return false;
-    if (From == To) return false;
+    bool IsLocal = LocalTypes.count(VarName);
+    if (!IsLocal && !GlobalTypes.count(VarName)) {
+        DEBUG_CODEGEN("  ERROR: Variable not found");
+        DUMP_SYMBOL_TABLE();
+        LogScopeError(VarName, CurrentContext.toString());
+        return false;
+    }
 
-    // Narrowing conversions (information loss):
-    // float → int (narrowing - loses decimal part)
-    if (From->isFloatTy() && To->isIntegerTy(32))
-        return true;
-    // float → bool (narrowing - loses magnitude)
-    if (From->isFloatTy() && To->isIntegerTy(1))
-        return true;
-    // int → bool (narrowing - loses magnitude, only keeps zero/non-zero)
-    if (From->isIntegerTy(32) && To->isIntegerTy(1))
-        return true;
-    // double → float (narrowing - loses precision)
-    if (From->isDoubleTy() && To->isFloatTy())
-        return true;
+    const MiniCType* VarType = IsLocal ? LocalTypes[VarName] : GlobalTypes[VarName];
+    const MiniCType* ValType = RHS->getResolvedType();
+    std::string Target = (IsLocal ? "local '" : "global '") + VarName + "'";
 
-    // Note: bool→int and bool→float are WIDENING per spec, not narrowing
-    return false;
+    if (!checkConversion(ValType, VarType, false, "assignment to " + Target)) {
+        LogTypeError("Type mismatch in assignment to " + Target, VarType, ValType);
+        return false;
+    }
+
+    ResolvedType = VarType;
+    return true;
 }
 
-// isWideningConversion - Check if conversion is widening (safe)
-static bool isWideningConversion(Type* From, Type* To) {
-    if (!From || !To) return false;
+// CallExprAST::sema - Arguments convert to the parameter types without narrowing
+bool CallExprAST::sema() {
+    if (!FunctionSignatures.count(Callee) && (Builtin = getBuiltin(Callee)) != BuiltinKind::None)
+        return semaBuiltin();
 
-    // int to float is widening
-    if (From->isIntegerTy(32) && To->isFloatTy())
-        return true;
+    const FunctionSignature* Sig = checkFunctionExists(Callee);
+    if (!Sig)
+        return false;
 
-    // bool to int is widening
-    if (From->isIntegerTy(1) && To->isIntegerTy(32))
-        return true;
+    // Check argument count
+    if (Sig->ParamTypes.size() != Args.size()) {
+        std::string msg = "Function '" + Callee + "' expects " +
+                         std::to_string(Sig->ParamTypes.size()) + " argument(s), but " +
+                         std::to_string(Args.size()) + " provided";
+        LogCompilerError(ErrorType::SEMANTIC_TYPE, msg);
+        return false;
+    }
 
-    // bool to float is widening (through int)
-    if (From->isIntegerTy(1) && To->isFloatTy())
-        return true;
+    for (size_t Idx = 0; Idx < Args.size(); Idx++) {
+        if (!Args[Idx]->sema())
+            return false;
 
-    // float to double is widening
-    if (From->isFloatTy() && To->isDoubleTy())
-        return true;
+        const MiniCType* ExpectedType = Sig->ParamTypes[Idx];
+        const MiniCType* ActualType = Args[Idx]->getResolvedType();
+        if (ActualType == ExpectedType)
+            continue;
 
-    return false;
-}
+        // Per spec: allow widening, disallow narrowing
+        if (isNarrowing(ActualType, ExpectedType)) {
+            std::string msg = "Narrowing conversion in argument " + std::to_string(Idx + 1) +
+                            " of function '" + Callee + "'";
+            msg += "\n  Expected: " + ExpectedType->Name;
+            msg += "\n  Provided: " + ActualType->Name;
+            LogCompilerError(ErrorType::SEMANTIC_TYPE, msg);
+            return false;
+        }
 
-// castToType - Perform type conversions with proper checking
-static Value* castToType(Value* V, Type* DestTy, bool allowNarrowing = true,
-                         const std::string& context = "") {
-    if (!V || !DestTy) {
-        DEBUG_CODEGEN("  ERROR: Null value or type in castToType");
-        return nullptr;
+        if (!checkConversion(ActualType, ExpectedType, false,
+                             "function call argument " + std::to_string(Idx + 1)))
+            return false;
     }
 
-    Type* SrcTy = V->getType();
+    ParamTypes = Sig->ParamTypes;
+    ResolvedType = Sig->ReturnType;
+    return true;
+}
 
-    if (SrcTy == DestTy)
-        return V;
+// builtinArity - Number of arguments a builtin takes
+static size_t builtinArity(BuiltinKind Kind) {
+    switch (Kind) {
+    case BuiltinKind::Fill:
+    case BuiltinKind::Copy:
+    case BuiltinKind::Sum:
+        return 2;
+    case BuiltinKind::Dot:
+        return 3;
+    default:
+        return 1;
+    }
+}
 
-    DEBUG_VERBOSE("  Type conversion needed: " + getTypeName(SrcTy) + " -> " + getTypeName(DestTy));
+// decayedType - The type an array has as a parameter: int[10][5] -> int*[5]
+static const MiniCType* decayedType(const MiniCType* T) {
+    if (!T->isArray()) return T;
+    std::vector<int> Trailing(T->Dims.begin() + 1, T->Dims.end());
+    return getMiniCType(T->Scalar, true, Trailing, T->Lanes);
+}
 
-    // Check for narrowing conversion
-    if (!allowNarrowing && isNarrowingConversion(SrcTy, DestTy)) {
-        std::string msg = "Narrowing conversion not allowed";
-        if (!context.empty()) {
-            msg += " in " + context;
-        }
-        msg += "\n  From: " + getTypeName(SrcTy) + "\n  To: " + getTypeName(DestTy);
+// semaArrayOperand - Type of a bulk builtin's array argument, which must name an
+// array or array parameter; nullptr after reporting anything else
+static const MiniCType* semaArrayOperand(ASTnode& Arg, const std::string& Callee, size_t Position) {
+    std::string msg = "Argument " + std::to_string(Position) + " of builtin '" + Callee + "' must name an array";
+    if (!Arg.isVariable()) {
         LogCompilerError(ErrorType::SEMANTIC_TYPE, msg);
         return nullptr;
     }
 
-    // Perform widening conversions
-
-    // int to float (widening)
-    if (SrcTy->isIntegerTy(32) && DestTy->isFloatTy()) {
-        DEBUG_VERBOSE("  Converting int to float");
-        return Builder.CreateSIToFP(V, DestTy, "itof");
+    const std::string& Name = static_cast<VariableASTnode&>(Arg).getName();
+    const MiniCType* T = checkVariableInScope(Name);
+    if (!T)
+        return nullptr;
+    if (!T->isArray() && !T->isPointer()) {
+        LogCompilerError(ErrorType::SEMANTIC_TYPE, msg, -1, -1, "'" + Name + "' has type: " + T->Name);
+        return nullptr;
     }
+    return T;
+}
 
-    // bool to int (widening)
-    if (SrcTy->isIntegerTy(1) && DestTy->isIntegerTy(32)) {
-        DEBUG_VERBOSE("  Converting bool to int");
-        return Builder.CreateZExt(V, DestTy, "btoi");
+// CallExprAST::semaBuiltin - hsum, hmin and hmax reduce one vector to its lane type
+bool CallExprAST::semaBuiltin() {
+    size_t Arity = builtinArity(Builtin);
+    if (Args.size() != Arity) {
+        LogCompilerError(ErrorType::SEMANTIC_TYPE, "Function '" + Callee + "' expects " + std::to_string(Arity) +
+                                                   " argument(s), but " + std::to_string(Args.size()) + " provided");
+        return false;
     }
+    if (Builtin != BuiltinKind::HSum && Builtin != BuiltinKind::HMin && Builtin != BuiltinKind::HMax)
+        return semaBulkBuiltin();
 
-    // bool to float (widening through int)
-    if (SrcTy->isIntegerTy(1) && DestTy->isFloatTy()) {
-        DEBUG_VERBOSE("  Converting bool to float (via int)");
-        Value* AsInt = Builder.CreateZExt(V, Type::getInt32Ty(TheContext), "btoi");
-        return Builder.CreateSIToFP(AsInt, DestTy, "itof");
-    }
+    if (!Args[0]->sema())
+        return false;
 
-    // double to float conversion (handle APFloat operations)
-    if (SrcTy->isDoubleTy() && DestTy->isFloatTy()) {
-        DEBUG_VERBOSE("  Converting double to float");
-        return Builder.CreateFPTrunc(V, DestTy, "fptrunc");
+    const MiniCType* ArgType = Args[0]->getResolvedType();
+    if (!ArgType->isVector()) {
+        LogCompilerError(ErrorType::SEMANTIC_TYPE, "Builtin '" + Callee + "' requires a vector argument",
+                       -1, -1, "Got: " + ArgType->Name);
+        return false;
     }
 
-    // float to double conversion
-    if (SrcTy->isFloatTy() && DestTy->isDoubleTy()) {
-        DEBUG_VERBOSE("  Converting float to double");
-        return Builder.CreateFPExt(V, DestTy, "fpext");
-    }
+    ParamTypes = {ArgType};
+    ResolvedType = getMiniCType(ArgType->Scalar);
+    return true;
+}
 
-    // Narrowing conversions (only if allowed)
-    if (allowNarrowing) {
-        // float to int (narrowing)
-        if (SrcTy->isFloatTy() && DestTy->isIntegerTy(32)) {
-            DEBUG_VERBOSE("  Converting float to int (narrowing - allowed)");
-            return Builder.CreateFPToSI(V, DestTy, "ftoi");
+// CallExprAST::semaBulkBuiltin - fill(a, v) and copy(dst, src) take their size from an
+// array declaration; sum(a, n) and dot(a, b, n) reduce n int or float elements
+bool CallExprAST::semaBulkBuiltin() {
+    const MiniCType* First = semaArrayOperand(*Args[0], Callee, 1);
+    if (!First)
+        return false;
+    ParamTypes = {First};
+
+    if (Builtin == BuiltinKind::Fill) {
+        if (!First->isArray()) {
+            LogCompilerError(ErrorType::SEMANTIC_TYPE, "Builtin 'fill' requires an array of known size",
+                           -1, -1, "Got: " + First->Name);
+            return false;
         }
+        const MiniCType* ElementType = getMiniCType(First->Scalar, false, {}, First->Lanes);
+        if (!Args[1]->sema() ||
+            !checkConversion(Args[1]->getResolvedType(), ElementType, false, "argument 2 of builtin 'fill'"))
+            return false;
+        ParamTypes.push_back(ElementType);
+        ResolvedType = getMiniCType(MiniCType::Void);
+        return true;
+    }
 
-        // int to bool (narrowing - used in conditionals)
-        if (SrcTy->isIntegerTy(32) && DestTy->isIntegerTy(1)) {
-            DEBUG_VERBOSE("  Converting int to bool (narrowing - allowed)");
-            return Builder.CreateICmpNE(V, ConstantInt::get(SrcTy, 0), "tobool");
+    if (Builtin == BuiltinKind::Copy) {
+        const MiniCType* Second = semaArrayOperand(*Args[1], Callee, 2);
+        if (!Second)
+            return false;
+        std::string Operands = "Destination: " + First->Name + ", source: " + Second->Name;
+        if (decayedType(First) != decayedType(Second) ||
+            (First->isArray() && Second->isArray() && First != Second)) {
+            LogCompilerError(ErrorType::SEMANTIC_TYPE, "Builtin 'copy' requires arrays of the same type",
+                           -1, -1, Operands);
+            return false;
         }
-
-        // float/double to bool for conditionals
-        if ((SrcTy->isFloatTy() || SrcTy->isDoubleTy()) && DestTy->isIntegerTy(1)) {
-            DEBUG_VERBOSE("  Converting float/double to bool");
-            return Builder.CreateFCmpONE(V, ConstantFP::get(SrcTy, 0.0), "tobool");
+        if (!First->isArray() && !Second->isArray()) {
+            LogCompilerError(ErrorType::SEMANTIC_TYPE, "Builtin 'copy' requires an array of known size",
+                           -1, -1, Operands);
+            return false;
         }
+        ParamTypes.push_back(Second);
+        ResolvedType = getMiniCType(MiniCType::Void);
+        return true;
     }
 
-    // Unsupported conversion
-    std::string msg = "Cannot convert between types";
-    if (!context.empty()) {
-        msg += " in " + context;
+    // sum and dot
+    if (First->Lanes || (First->Scalar != MiniCType::Int && First->Scalar != MiniCType::Float)) {
+        LogCompilerError(ErrorType::SEMANTIC_TYPE, "Builtin '" + Callee + "' requires an int or float array",
+                       -1, -1, "Got: " + First->Name);
+        return false;
+    }
+    if (Builtin == BuiltinKind::Dot) {
+        const MiniCType* Second = semaArrayOperand(*Args[1], Callee, 2);
+        if (!Second)
+            return false;
+        if (Second->Scalar != First->Scalar || Second->Lanes) {
+            LogCompilerError(ErrorType::SEMANTIC_TYPE, "Builtin 'dot' requires arrays with the same element type",
+                           -1, -1, "Got: " + First->Name + ", " + Second->Name);
+            return false;
+        }
+        ParamTypes.push_back(Second);
     }
-    msg += "\n  From: " + getTypeName(SrcTy) + "\n  To: " + getTypeName(DestTy);
-    LogCompilerError(ErrorType::SEMANTIC_TYPE, msg);
-    return nullptr;
+
+    ASTnode& Count = *Args.back();
+    const MiniCType* IntTy = getMiniCType(MiniCType::Int);
+    if (!Count.sema() ||
+        !checkConversion(Count.getResolvedType(), IntTy, false, "element count of builtin '" + Callee + "'"))
+        return false;
+    ParamTypes.push_back(IntTy);
+    ResolvedType = getMiniCType(First->Scalar);
+    return true;
 }
 
-// checkTypeCompatibility - Check if two types are compatible for operations
-static bool checkTypeCompatibility(Type* T1, Type* T2, const std::string& operation) {
-    if (!T1 || !T2) return false;
+// IfExprAST::sema - Conditions convert to bool, narrowing included
+bool IfExprAST::sema() {
+    if (!Cond->sema())
+        return false;
+    if (!checkConversion(Cond->getResolvedType(), getMiniCType(MiniCType::Bool), true))
+        return false;
+    if (!Then->sema())
+        return false;
+    return !Else || Else->sema();
+}
 
-    // Same types are always compatible
-    if (T1 == T2) return true;
+// WhileExprAST::sema - Conditions convert to bool, narrowing included
+bool WhileExprAST::sema() {
+    if (!Cond->sema())
+        return false;
+    if (!checkConversion(Cond->getResolvedType(), getMiniCType(MiniCType::Bool), true))
+        return false;
+    return Body->sema();
+}
 
-    // Numeric types are compatible with each other (with conversion)
-    bool t1Numeric = T1->isIntegerTy(32) || T1->isFloatTy() || T1->isIntegerTy(1);
-    bool t2Numeric = T2->isIntegerTy(32) || T2->isFloatTy() || T2->isIntegerTy(1);
+// ReturnAST::sema - The value converts to the return type without narrowing
+bool ReturnAST::sema() {
+    const std::string& FunctionName = CurrentContext.currentFunction;
+    FunctionReturnType = CurrentSignature->ReturnType;
+    bool VoidFunction = FunctionReturnType == getMiniCType(MiniCType::Void);
 
-    if (t1Numeric && t2Numeric) return true;
+    // Case 1: Void return
+    if (!Val) {
+        if (!VoidFunction) {
+            LogErrorV("Non-void function '" + FunctionName + "' must return a value");
+            return false;
+        }
+        return true;
+    }
 
-    DEBUG_CODEGEN("  Type incompatibility in " + operation);
-    DEBUG_CODEGEN("    Type 1: " + getTypeName(T1));
-    DEBUG_CODEGEN("    Type 2: " + getTypeName(T2));
+    // Case 2: Value return
+    if (VoidFunction) {
+        LogErrorV("Void function '" + FunctionName + "' cannot return a value");
+        return false;
+    }
 
-    return false;
+    if (!Val->sema())
+        return false;
+
+    const MiniCType* RetType = Val->getResolvedType();
+    if (RetType == FunctionReturnType)
+        return true;
+
+    // Check if this is a narrowing conversion (NOT ALLOWED per spec)
+    if (isNarrowing(RetType, FunctionReturnType)) {
+        LogTypeError("Return type mismatch in function '" + FunctionName +
+                     "' - narrowing conversion not allowed",
+                     FunctionReturnType, RetType);
+        return false;
+    }
+
+    if (!checkConversion(RetType, FunctionReturnType, /*allowNarrowing=*/false)) {
+        LogTypeError("Cannot convert return value type", FunctionReturnType, RetType);
+        return false;
+    }
+    return true;
 }
 
-// Duplicate checkNarrowingConversion removed; use the earlier definition above.
+// BlockAST::sema - Declarations may shadow outer ones but not each other
+bool BlockAST::sema() {
+    std::map<std::string, const MiniCType*> OldBindings;
+    std::set<std::string> CurrentBlockVars;  // Track variables declared in THIS block
 
-// promoteTypes - Promote two values to common type for binary operations
-static void promoteTypes(Value*& L, Value*& R) {
-    Type* LTy = L->getType();
-    Type* RTy = R->getType();
+    for (auto& decl : LocalDecls) {
+        const std::string& VarName = decl->getName();
 
-    if (LTy == RTy)
-        return;
+        // Check for duplicate declaration in same scope
+        if (!CurrentBlockVars.insert(VarName).second) {
+            LogCompilerError(ErrorType::SEMANTIC_SCOPE,
+                           "Redeclaration of variable '" + VarName + "' in same scope",
+                           CurTok.lineNo, CurTok.columnNo);
+            return false;
+        }
 
-    // **FIX: Normalize f64 to f32 first**
-    if (LTy->isDoubleTy()) {
-        L = Builder.CreateFPTrunc(L, Type::getFloatTy(TheContext), "fptrunc");
-        LTy = L->getType();
-    }
-    if (RTy->isDoubleTy()) {
-        R = Builder.CreateFPTrunc(R, Type::getFloatTy(TheContext), "fptrunc");
-        RTy = R->getType();
+        // Save old binding if variable already exists in outer scope (shadowing allowed)
+        auto It = LocalTypes.find(VarName);
+        if (It != LocalTypes.end())
+            OldBindings[VarName] = It->second;
+
+        decl->sema();
     }
 
-    // Now promote to float if either is float
-    if (LTy->isFloatTy() && RTy->isIntegerTy(32)) {
-        R = Builder.CreateSIToFP(R, LTy, "itof");
-    } else if (RTy->isFloatTy() && LTy->isIntegerTy(32)) {
-        L = Builder.CreateSIToFP(L, RTy, "itof");
+    for (auto& stmt : Stmts) {
+        if (stmt && !stmt->sema())  // null statements are empty ones
+            return false;
     }
-    // Promote bool to int if needed
-    else if (LTy->isIntegerTy(32) && RTy->isIntegerTy(1)) {
-        R = Builder.CreateZExt(R, LTy, "btoi");
-    } else if (RTy->isIntegerTy(32) && LTy->isIntegerTy(1)) {
-        L = Builder.CreateZExt(L, RTy, "btoi");
+
+    // Restore old bindings and remove variables that went out of scope
+    for (auto& decl : LocalDecls) {
+        auto It = OldBindings.find(decl->getName());
+        if (It != OldBindings.end())
+            LocalTypes[It->first] = It->second;
+        else
+            LocalTypes.erase(decl->getName());
     }
-    // Promote bool to float through int
-    else if (LTy->isFloatTy() && RTy->isIntegerTy(1)) {
-        R = Builder.CreateZExt(R, Type::getInt32Ty(TheContext), "btoi");
-        R = Builder.CreateSIToFP(R, LTy, "itof");
-    } else if (RTy->isFloatTy() && LTy->isIntegerTy(1)) {
-        L = Builder.CreateZExt(L, Type::getInt32Ty(TheContext), "btoi");
-        L = Builder.CreateSIToFP(L, RTy, "itof");
+    return true;
+}
+
+bool VarDeclAST::sema() {
+    LocalTypes[getName()] = Type;
+    registerVariable(getName(), Type, false);
+    return true;
+}
+
+bool GlobVarDeclAST::sema() {
+    if (GlobalTypes.count(getName())) {
+        LogCompilerError(ErrorType::SEMANTIC_SCOPE,
+                       "Redeclaration of global variable '" + getName() + "'");
+        return false;
     }
+    GlobalTypes[getName()] = Type;
+    registerVariable(getName(), Type, true);
+    return true;
 }
 
-// BinaryExprAST::codegen - Generate code for binary operators
-Value* BinaryExprAST::codegen() {
-    DEBUG_CODEGEN("Generating binary expression: " + Op);
+bool ArrayDeclAST::sema() {
+    if (!IsGlobal) {
+        LocalTypes[Name] = Type;
+        registerVariable(Name, Type, false);
+        return true;
+    }
 
-    Value* L = LHS->codegen();
-    Value* R = RHS->codegen();
+    if (GlobalTypes.count(Name)) {
+        LogCompilerError(ErrorType::SEMANTIC_SCOPE,
+                       "Redeclaration of global variable '" + Name + "'");
+        return false;
+    }
+    GlobalTypes[Name] = Type;
+    registerVariable(Name, Type, true);
+    return true;
+}
 
-    if (!L || !R) {
-        DEBUG_CODEGEN("  ERROR: Failed to generate operands");
-        return nullptr;
+// ArrayAccessAST::semaBase - The subscripted variable must be an array or array
+// parameter taking exactly one subscript per dimension
+bool ArrayAccessAST::semaBase() {
+    const MiniCType* VarType = checkVariableInScope(Name);
+    if (!VarType)
+        return false;
+
+    if (VarType->isScalar()) {
+        LogCompilerError(ErrorType::SEMANTIC_TYPE,
+                       "Subscript operator [] requires array, pointer or vector type, got scalar",
+                       -1, -1,
+                       "Variable '" + Name + "' has type: " + VarType->Name);
+        return false;
+    }
+
+    // One subscript past the rank of an array of vectors (or the only one on
+    // a vector variable) selects a lane
+    size_t Rank = VarType->Dims.size() + (VarType->isPointer() ? 1 : 0);
+    LaneAccess = VarType->Lanes && Indices.size() == Rank + 1;
+    if (Indices.size() != Rank && !LaneAccess) {
+        LogCompilerError(ErrorType::SEMANTIC_TYPE,
+                       "Array dimension mismatch for '" + Name + "'", -1, -1,
+                       "Declared as " + VarType->Name + " with " + std::to_string(Rank) +
+                       " dimension(s), indexed with " + std::to_string(Indices.size()));
+        return false;
+    }
+
+    int64_t Lane;
+    if (LaneAccess && Indices.back()->getIntConstant(Lane)) {
+        if (Lane < 0 || Lane >= VarType->Lanes) {
+            LogCompilerError(ErrorType::SEMANTIC_TYPE,
+                           "Vector lane " + std::to_string(Lane) + " out of range for '" +
+                           Name + "'", -1, -1,
+                           VarType->elementName() + " has " + std::to_string(VarType->Lanes) + " lanes");
+            return false;
+        }
     }
 
-    DEBUG_VERBOSE("  LHS type: " + getTypeName(L->getType()));
-    DEBUG_VERBOSE("  RHS type: " + getTypeName(R->getType()));
+    BaseType = VarType;
+    ResolvedType = LaneAccess ? getMiniCType(VarType->Scalar)
+                              : getMiniCType(VarType->Scalar, false, {}, VarType->Lanes);
+    return true;
+}
 
-    Type* OrigLTy = L->getType();
-    Type* OrigRTy = R->getType();
+// ArrayAccessAST::sema - Reads take int or bool subscripts
+bool ArrayAccessAST::sema() {
+    if (!semaBase())
+        return false;
 
-    // Validate arithmetic operators require numeric types (not bool)
-    if (Op == "+" || Op == "-" || Op == "*" || Op == "/" || Op == "%") {
-        if (OrigLTy->isIntegerTy(1) || OrigRTy->isIntegerTy(1)) {
+    for (size_t i = 0; i < Indices.size(); i++) {
+        if (!Indices[i]->sema())
+            return false;
+
+        // Validate index type - must be integer (int or bool, not float)
+        const MiniCType* IndexType = Indices[i]->getResolvedType();
+        if (IndexType == getMiniCType(MiniCType::Float)) {
             LogCompilerError(ErrorType::SEMANTIC_TYPE,
-                           "Arithmetic operator '" + Op + "' requires numeric operands (int or float), not bool",
+                           "Array index must be integer type, not float",
                            -1, -1,
-                           "LHS: " + getTypeName(OrigLTy) + ", RHS: " + getTypeName(OrigRTy));
-            return nullptr;
+                           "Index " + std::to_string(i) + " for array '" + Name + "'");
+            return false;
+        }
+        if (!isNumeric(IndexType)) {
+            LogCompilerError(ErrorType::SEMANTIC_TYPE, "Array index must be integer type",
+                           -1, -1, "Got: " + IndexType->Name);
+            return false;
         }
     }
 
-    promoteTypes(L, R);
+    return true;
+}
 
-    DEBUG_VERBOSE("  After promotion: " + getTypeName(L->getType()));
+// ArrayAssignmentExprAST::sema - Unlike reads, stores truncate float subscripts;
+// the value converts to the element type without narrowing
+bool ArrayAssignmentExprAST::sema() {
+    if (!RHS->sema())
+        return false;
+    if (!LHS->semaBase())
+        return false;
+
+    for (auto& Index : LHS->getIndices()) {
+        if (!Index->sema())
+            return false;
+        if (!isNumeric(Index->getResolvedType())) {
+            LogErrorV("Array index must be an integer");
+            return false;
+        }
+    }
 
-    Type* OpType = L->getType();
+    ResolvedType = LHS->getResolvedType();
+    if (!checkConversion(RHS->getResolvedType(), ResolvedType, false, "array element assignment")) {
+        LogErrorV("Type mismatch in array assignment");
+        return false;
+    }
+    return true;
+}
 
-    if (Op == "+") {
-        DEBUG_CODEGEN("  Creating addition");
-        if (OpType->isFloatingPointTy())
-            return Builder.CreateFAdd(L, R, "fadd");
-        else if (OpType->isIntegerTy())
-            return Builder.CreateAdd(L, R, "add");
-        else {
-            std::string msg = "Invalid operand types for operator '+'";
-            LogCompilerError(ErrorType::SEMANTIC_TYPE, msg, -1, -1,
-                           "LHS: " + getTypeName(OrigLTy) + ", RHS: " + getTypeName(OrigRTy));
-            return nullptr;
-        }
+// FunctionPrototypeAST::sema - Declare the function, or check the signature
+// against an earlier declaration of it
+bool FunctionPrototypeAST::sema() {
+    std::vector<const MiniCType*> ParamTypes;
+    for (auto& param : Params)
+        ParamTypes.push_back(param->getType());
+
+    auto It = FunctionSignatures.find(Name);
+    if (It == FunctionSignatures.end()) {
+        FunctionSignatures[Name] = {Type, ParamTypes, false};
+        FunctionNameIndex.insert(Name);
+        return true;
     }
 
-    if (Op == "-") {
-        DEBUG_CODEGEN("  Creating subtraction");
-        if (OpType->isFloatingPointTy())
-            return Builder.CreateFSub(L, R, "fsub");
-        else if (OpType->isIntegerTy())
-            return Builder.CreateSub(L, R, "sub");
-        else {
-            std::string msg = "Invalid operand types for operator '-'";
-            LogCompilerError(ErrorType::SEMANTIC_TYPE, msg, -1, -1,
-                           "LHS: " + getTypeName(OrigLTy) + ", RHS: " + getTypeName(OrigRTy));
-            return nullptr;
-        }
+    const FunctionSignature& Earlier = It->second;
+    if (Earlier.ReturnType != Type || Earlier.ParamTypes != ParamTypes) {
+        LogCompilerError(ErrorType::SEMANTIC_SCOPE,
+                       "Conflicting types for function '" + Name + "' (redeclaration)",
+                       -1, -1,
+                       "Declared as " + signatureName(Earlier.ReturnType, Earlier.ParamTypes) +
+                       ", now " + signatureName(Type, ParamTypes));
+        return false;
     }
+    return true;
+}
 
-    if (Op == "*") {
-        DEBUG_CODEGEN("  Creating multiplication");
-        if (OpType->isFloatingPointTy())
-            return Builder.CreateFMul(L, R, "fmul");
-        else if (OpType->isIntegerTy())
-            return Builder.CreateMul(L, R, "mul");
-        else {
-            std::string msg = "Invalid operand types for operator '*'";
-            LogCompilerError(ErrorType::SEMANTIC_TYPE, msg, -1, -1,
-                           "LHS: " + getTypeName(OrigLTy) + ", RHS: " + getTypeName(OrigRTy));
-            return nullptr;
-        }
+// FunctionDeclAST::sema - Declare the function and analyze its body with the
+// parameters in scope. A failed definition is forgotten again
+bool FunctionDeclAST::sema() {
+    auto Existing = FunctionSignatures.find(getName());
+    if (Existing != FunctionSignatures.end() && Existing->second.Defined) {
+        LogCompilerError(ErrorType::SEMANTIC_SCOPE,
+                       "Redefinition of function '" + getName() + "'",
+                       CurTok.lineNo, CurTok.columnNo);
+        return false;
     }
 
-    if (Op == "/") {
-        DEBUG_CODEGEN("  Creating division");
-        if (OpType->isFloatingPointTy())
-            return Builder.CreateFDiv(L, R, "fdiv");
-        else if (OpType->isIntegerTy())
-            return Builder.CreateSDiv(L, R, "sdiv");
-        else {
-            std::string msg = "Invalid operand types for operator '/'";
-            LogCompilerError(ErrorType::SEMANTIC_TYPE, msg, -1, -1,
-                           "LHS: " + getTypeName(OrigLTy) + ", RHS: " + getTypeName(OrigRTy));
-            return nullptr;
+    if (!Proto->sema())
+        return false;
+
+    // If this is a forward declaration (no body), the signature is all there is
+    if (!Block)
+        return true;
+
+    FunctionSignature& Sig = FunctionSignatures[getName()];
+    Sig.Defined = true;
+
+    // Check for duplicate parameter names
+    std::set<std::string> ParamNames;
+    for (auto& param : Proto->getParams()) {
+        if (!ParamNames.insert(param->getName()).second) {
+            LogCompilerError(ErrorType::SEMANTIC_SCOPE,
+                           "Duplicate parameter name '" + param->getName() + "' in function '" +
+                           getName() + "'",
+                           CurTok.lineNo, CurTok.columnNo);
+            return false;
         }
     }
 
-    if (Op == "%") {
-        DEBUG_CODEGEN("  Creating modulo");
-        if (OpType->isIntegerTy())
-            return Builder.CreateSRem(L, R, "mod");
-        else {
-            std::string msg = "Modulo operator '%' requires integer operands";
-            LogCompilerError(ErrorType::SEMANTIC_TYPE, msg, -1, -1,
-                           "Got: " + getTypeName(OpType));
-            return nullptr;
-        }
-      }
+    LocalTypes.clear();
+    for (auto& param : Proto->getParams()) {
+        LocalTypes[param->getName()] = param->getType();
+        registerVariable(param->getName(), param->getType(), false);
+    }
 
-    if (Op == "<") {
-    DEBUG_CODEGEN("  Creating less than comparison");
-    if (OpType->isFloatingPointTy())
-        return Builder.CreateFCmpOLT(L, R, "flt");
-    else if (OpType->isIntegerTy())
-        return Builder.CreateICmpSLT(L, R, "lt");
-    else {
-        std::string msg = "Invalid operand types for operator '<'";
-        LogCompilerError(ErrorType::SEMANTIC_TYPE, msg, -1, -1,
-                       "Got: " + getTypeName(OpType));
-        return nullptr;
-      }
+    CurrentSignature = &Sig;
+    CurrentContext.currentFunction = getName();
+    bool Valid = Block->sema();
+    CurrentContext.currentFunction.clear();
+    CurrentSignature = nullptr;
+
+    if (Valid)
+        analyzeAssignments(*Block);
+
+    for (auto& param : Proto->getParams()) {
+        SymbolTypeTable.erase(param->getName());
+        SymbolNameIndex.erase(param->getName());
     }
 
-    if (Op == "<=") {
-        DEBUG_CODEGEN("  Creating less than or equal comparison");
-        if (OpType->isFloatingPointTy())
-            return Builder.CreateFCmpOLE(L, R, "fle");
-        else if (OpType->isIntegerTy())
-            return Builder.CreateICmpSLE(L, R, "le");
-        else {
-            std::string msg = "Invalid operand types for operator '<='";
-            LogCompilerError(ErrorType::SEMANTIC_TYPE, msg, -1, -1,
-                          "Got: " + getTypeName(OpType));
-            return nullptr;
-        }
+    if (!Valid) {
+        FunctionNameIndex.erase(getName());
+        FunctionSignatures.erase(getName());
     }
+    return Valid;
+}
 
-    if (Op == ">") {
-        DEBUG_CODEGEN("  Creating greater than comparison");
-        if (OpType->isFloatingPointTy())
-            return Builder.CreateFCmpOGT(L, R, "fgt");
-        else if (OpType->isIntegerTy())
-            return Builder.CreateICmpSGT(L, R, "gt");
-        else {
-            std::string msg = "Invalid operand types for operator '>'";
-            LogCompilerError(ErrorType::SEMANTIC_TYPE, msg, -1, -1,
-                          "Got: " + getTypeName(OpType));
-            return nullptr;
-        }
+//==============================================================================
+// DEFINITE ASSIGNMENT
+// Locals are zero-initialized where declared, and arrays and vectors may be
+// written piecewise. A flow-sensitive pass over each function body finds the
+// declarations that no read can reach before a whole-variable write, so their
+// zero stores (or memset, for arrays) are left out. It runs once sema has
+// accepted the function.
+//==============================================================================
+
+// DefiniteAssignment - The locals certainly written at one point of a function body
+struct DefiniteAssignment {
+    std::map<std::string, std::vector<DeclAST*>> InScope;  // innermost declaration last
+    std::set<DeclAST*> Assigned;
+    bool Reachable = true;  // false after a return
+
+    // lookup - The local a name refers to here; nullptr for parameters and globals
+    DeclAST* lookup(const std::string& Name) const {
+        auto It = InScope.find(Name);
+        return It == InScope.end() || It->second.empty() ? nullptr : It->second.back();
     }
 
-    if (Op == ">=") {
-        DEBUG_CODEGEN("  Creating greater than or equal comparison");
-        if (OpType->isFloatingPointTy())
-            return Builder.CreateFCmpOGE(L, R, "fge");
-        else if (OpType->isIntegerTy())
-            return Builder.CreateICmpSGE(L, R, "ge");
-        else {
-            std::string msg = "Invalid operand types for operator '>='";
-            LogCompilerError(ErrorType::SEMANTIC_TYPE, msg, -1, -1,
-                          "Got: " + getTypeName(OpType));
-            return nullptr;
-        }
+    // declare - A declaration starts unwritten, also when a loop reaches it again
+    void declare(DeclAST* Decl) {
+        InScope[Decl->getName()].push_back(Decl);
+        Assigned.erase(Decl);
+        Decl->setNeedsZeroInit(false);
     }
 
-    if (Op == "==") {
-        DEBUG_CODEGEN("  Creating equality comparison");
-        if (OpType->isFloatingPointTy())
-            return Builder.CreateFCmpOEQ(L, R, "feq");
-        else if (OpType->isIntegerTy())
-            return Builder.CreateICmpEQ(L, R, "eq");
-        else {
-            std::string msg = "Invalid operand types for operator '=='";
-            LogCompilerError(ErrorType::SEMANTIC_TYPE, msg, -1, -1,
-                          "Got: " + getTypeName(OpType));
-            return nullptr;
-        }
+    void undeclare(DeclAST* Decl) {
+        InScope[Decl->getName()].pop_back();
+        Assigned.erase(Decl);
     }
 
-    if (Op == "!=") {
-        DEBUG_CODEGEN("  Creating inequality comparison");
-        if (OpType->isFloatingPointTy())
-            return Builder.CreateFCmpONE(L, R, "fne");
-        else if (OpType->isIntegerTy())
-            return Builder.CreateICmpNE(L, R, "ne");
-        else {
-            std::string msg = "Invalid operand types for operator '!='";
-            LogCompilerError(ErrorType::SEMANTIC_TYPE, msg, -1, -1,
-                          "Got: " + getTypeName(OpType));
-            return nullptr;
+    // read - A read of a local that may not have been written yet sees its zero
+    void read(const std::string& Name) {
+        DeclAST* Decl = lookup(Name);
+        if (Decl && Reachable && !Assigned.count(Decl))
+            Decl->setNeedsZeroInit(true);
+    }
+
+    void write(const std::string& Name) {
+        if (DeclAST* Decl = lookup(Name))
+            Assigned.insert(Decl);
+    }
+
+    // merge - Join with the state at the end of another path to the same point
+    void merge(const DefiniteAssignment& Other) {
+        if (!Other.Reachable)
+            return;
+        if (!Reachable) {
+            Assigned = Other.Assigned;
+            Reachable = true;
+            return;
         }
+        for (auto It = Assigned.begin(); It != Assigned.end();)
+            It = Other.Assigned.count(*It) ? std::next(It) : Assigned.erase(It);
     }
+};
 
-    if (Op == "&&") {
-        DEBUG_CODEGEN("  Creating logical AND");
-        // Logical operators allow narrowing (like conditionals) per MiniC spec
-        L = castToType(L, Type::getInt1Ty(TheContext), true, "logical AND left operand");
-        R = castToType(R, Type::getInt1Ty(TheContext), true, "logical AND right operand");
-        if (!L || !R) return nullptr;
-        return Builder.CreateAnd(L, R, "and");
+// analyzeAssignments - Decide which declarations in a function body need zeroing
+static void analyzeAssignments(ASTnode& Body) {
+    DefiniteAssignment DA;
+    Body.checkAssigned(DA);
+}
+
+void VariableASTnode::checkAssigned(DefiniteAssignment& DA) {
+    DA.read(Name);
+}
+
+// BinaryExprAST::checkAssigned - The right operand of && and || may not run
+void BinaryExprAST::checkAssigned(DefiniteAssignment& DA) {
+    LHS->checkAssigned(DA);
+    if (Op == "&&" || Op == "||") {
+        DefiniteAssignment Maybe = DA;
+        RHS->checkAssigned(Maybe);
+        return;
     }
+    RHS->checkAssigned(DA);
+}
 
-    if (Op == "||") {
-        DEBUG_CODEGEN("  Creating logical OR");
-        // Logical operators allow narrowing (like conditionals) per MiniC spec
-        L = castToType(L, Type::getInt1Ty(TheContext), true, "logical OR left operand");
-        R = castToType(R, Type::getInt1Ty(TheContext), true, "logical OR right operand");
-        if (!L || !R) return nullptr;
-        return Builder.CreateOr(L, R, "or");
+void UnaryExprAST::checkAssigned(DefiniteAssignment& DA) {
+    Operand->checkAssigned(DA);
+}
+
+void AssignmentExprAST::checkAssigned(DefiniteAssignment& DA) {
+    RHS->checkAssigned(DA);
+    DA.write(VarName);
+}
+
+void ArrayAccessAST::checkAssigned(DefiniteAssignment& DA) {
+    for (auto& Index : Indices)
+        Index->checkAssigned(DA);
+    DA.read(Name);
+}
+
+// ArrayAssignmentExprAST::checkAssigned - Storing one element writes only part of the
+// variable; storing a lane also reads the rest of the vector
+void ArrayAssignmentExprAST::checkAssigned(DefiniteAssignment& DA) {
+    RHS->checkAssigned(DA);
+    for (auto& Index : LHS->getIndices())
+        Index->checkAssigned(DA);
+    if (LHS->isLaneAccess())
+        DA.read(LHS->getName());
+}
+
+// CallExprAST::checkAssigned - fill and copy write their whole destination array
+void CallExprAST::checkAssigned(DefiniteAssignment& DA) {
+    if (Builtin == BuiltinKind::Fill || Builtin == BuiltinKind::Copy) {
+        Args[1]->checkAssigned(DA);
+        DA.write(static_cast<VariableASTnode&>(*Args[0]).getName());
+        return;
     }
+    for (auto& Arg : Args)
+        Arg->checkAssigned(DA);
+}
 
-    LogCompilerError(ErrorType::SEMANTIC_OTHER,
-                    "Unknown binary operator: '" + Op + "'");
-    return nullptr;
+void IfExprAST::checkAssigned(DefiniteAssignment& DA) {
+    Cond->checkAssigned(DA);
+    DefiniteAssignment ThenDA = DA;
+    Then->checkAssigned(ThenDA);
+    if (Else)
+        Else->checkAssigned(DA);
+    DA.merge(ThenDA);
 }
 
-// UnaryExprAST::codegen - Generate code for unary operators
-Value* UnaryExprAST::codegen() {
-    DEBUG_CODEGEN("Generating unary expression: " + Op);
+// WhileExprAST::checkAssigned - The body may run no times; later iterations start from
+// a superset of what the first one sees, so one visit finds every unsafe read
+void WhileExprAST::checkAssigned(DefiniteAssignment& DA) {
+    Cond->checkAssigned(DA);
+    DefiniteAssignment BodyDA = DA;
+    Body->checkAssigned(BodyDA);
+}
 
-    Value* OperandV = Operand->codegen();
-    if (!OperandV) {
-        DEBUG_CODEGEN("  ERROR: Failed to generate operand");
-        return nullptr;
+void ReturnAST::checkAssigned(DefiniteAssignment& DA) {
+    if (Val)
+        Val->checkAssigned(DA);
+    DA.Reachable = false;
+}
+
+void BlockAST::checkAssigned(DefiniteAssignment& DA) {
+    for (auto& decl : LocalDecls)
+        DA.declare(decl.get());
+    for (auto& stmt : Stmts) {
+        if (stmt)
+            stmt->checkAssigned(DA);
     }
+    for (auto& decl : LocalDecls)
+        DA.undeclare(decl.get());
+}
 
-    Type* OpType = OperandV->getType();
-    DEBUG_VERBOSE("  Operand type: " + getTypeName(OpType));
+//===----------------------------------------------------------------------===//
+// Code Generation
+//===----------------------------------------------------------------------===//
 
-    if (Op == "-") {
-        if (OpType->isFloatingPointTy()) {
-            DEBUG_CODEGEN("  Creating floating-point negation");
-            return Builder.CreateFNeg(OperandV, "fneg");
-        } else if (OpType->isIntegerTy(32)) {
-            DEBUG_CODEGEN("  Creating integer negation");
-            return Builder.CreateNeg(OperandV, "neg");
-        } else {
-            std::string msg = "Unary operator '-' requires numeric operand";
-            LogCompilerError(ErrorType::SEMANTIC_TYPE, msg, -1, -1,
-                           "Got: " + getTypeName(OpType));
-            return nullptr;
+//===----------------------------------------------------------------------===//
+// Symbol Tables and Helper Functions
+//===----------------------------------------------------------------------===//
+
+//==============================================================================
+// HELPER FUNCTIONS
+// Utility functions for type conversion, symbol tables, and code generation
+//==============================================================================
+
+// setInternalLinkage - Make a module-private definition internal and dso_local. Functions
+// also switch to fastcc, and so must every call to them emitted so far
+static void setInternalLinkage(GlobalValue* GV) {
+    GV->setLinkage(GlobalValue::InternalLinkage);
+    GV->setDSOLocal(true);
+
+    Function* F = dyn_cast<Function>(GV);
+    if (!F) return;
+    F->setCallingConv(CallingConv::Fast);
+    for (User* U : F->users())
+        if (auto* Call = dyn_cast<CallInst>(U))
+            if (Call->getCalledFunction() == F) Call->setCallingConv(CallingConv::Fast);
+}
+
+// CreateEntryBlockAlloca - Create alloca in entry block of function
+// From LLVM Tutorial Chapter 7
+static AllocaInst* CreateEntryBlockAlloca(Function *TheFunction,
+                                          const std::string &VarName,
+                                          Type* VarType) {
+    IRBuilder<> TmpB(&TheFunction->getEntryBlock(),
+                     TheFunction->getEntryBlock().begin());
+    return TmpB.CreateAlloca(VarType, nullptr, VarName);
+}
+
+// getParamGEPType - Type the index'th subscript of an array parameter steps over.
+// For int*[3][4] that is [3 x [4 x i32]], then [4 x i32], then i32
+static Type* getParamGEPType(const MiniCType* ParamType, size_t Index) {
+    Type* T = ParamType->PointeeTy;
+    for (size_t i = 0; i < Index; i++) {
+        auto* ArrTy = dyn_cast<llvm::ArrayType>(T);
+        if (!ArrTy) return ParamType->ElementTy;
+        T = ArrTy->getElementType();
+    }
+    return T;
+}
+
+// lookupVariableAddress - Storage of a variable: its local alloca, else the global
+static Value* lookupVariableAddress(const std::string& Name) {
+    auto It = NamedValues.find(Name);
+    if (It != NamedValues.end() && It->second)
+        return It->second;
+    return GlobalValues[Name];
+}
+
+// loadArrayParam - The caller's array an array parameter points to. Loads of aligned(N)
+// parameters carry !align, so the alignment survives once mem2reg forwards the argument.
+static Value* loadArrayParam(const std::string& Name, Value* Addr, const MiniCType* Type) {
+    LoadInst* Ptr = Builder.CreateLoad(Type->LLVMTy, Addr, Name + "_ptr");
+    auto It = ParamAligns.find(Addr);
+    if (It != ParamAligns.end())
+        Ptr->setMetadata(LLVMContext::MD_align,
+                         MDNode::get(TheContext, ConstantAsMetadata::get(Builder.getInt64(It->second.value()))));
+    return Ptr;
+}
+
+// emitConversion - Lower an implicit conversion the semantic pass accepted
+static Value* emitConversion(Value* V, const MiniCType* From, const MiniCType* To) {
+    if (From == To)
+        return V;
+
+    // A scalar becomes a vector by converting to the lane type and splatting
+    if (To->isVector())
+        return Builder.CreateVectorSplat(To->Lanes, emitConversion(V, From, getMiniCType(To->Scalar)),
+                                         "splat");
+
+    Type* DestTy = To->LLVMTy;
+    switch (To->Scalar) {
+    case MiniCType::Float:
+        // bool to float goes through int
+        if (From->Scalar == MiniCType::Bool)
+            V = Builder.CreateZExt(V, Type::getInt32Ty(TheContext), "btoi");
+        return Builder.CreateSIToFP(V, DestTy, "itof");
+    case MiniCType::Int:
+        if (From->Scalar == MiniCType::Bool)
+            return Builder.CreateZExt(V, DestTy, "btoi");
+        return Builder.CreateFPToSI(V, DestTy, "ftoi");
+    case MiniCType::Bool:
+        if (From->Scalar == MiniCType::Int)
+            return Builder.CreateICmpNE(V, ConstantInt::get(V->getType(), 0), "tobool");
+        return Builder.CreateFCmpONE(V, ConstantFP::get(V->getType(), 0.0), "tobool");
+    default:
+        return V;
+    }
+}
+
+//==============================================================================
+// INCREMENTAL FUNCTION CACHE
+// Per-function reuse of optimized IR across compilations (--function-cache)
+//==============================================================================
+
+// A function definition seen by the cache while parsing
+struct FunctionCacheEntry {
+    std::string Name;
+    std::string Path;                    // <cache dir>/<key>.bc
+    std::unique_ptr<Module> CachedBody;  // set on a hit, linked in once parsing is done
+};
+
+static std::vector<FunctionCacheEntry> FunctionCacheEntries;
+
+// getCompilerBuildID - Identifies this build of mccomp inside cache keys
+static std::string getCompilerBuildID() {
+    return std::string("mccomp " LLVM_VERSION_STRING " ") + __DATE__ + " " + __TIME__;
+}
+
+// computeFunctionCacheKey - Hash the function's tokens together with the signatures
+// of every global and function it names, and the settings that shape its IR
+static std::string computeFunctionCacheKey(const TokenRecording& Recording) {
+    MD5 Hasher;
+    auto Add = [&](StringRef Field) {
+        Hasher.update(Field);
+        Hasher.update(StringRef("\0", 1));
+    };
+
+    Add(getCompilerBuildID());
+    Add(sys::getDefaultTargetTriple());
+    Add(sys::getHostCPUName());
+    Add("-O" + std::to_string(Opts.OptLevel));
+    Add(Opts.SiblingCalls ? "sibling-calls" : "no-sibling-calls");
+    Add(Opts.WrapV ? "wrapv" : "no-wrapv");
+    Add("fp-math=" + fastMathName());
+    Add("array-align=" + std::to_string(Opts.ArrayAlign));
+    Add("index-width=" + std::to_string(Opts.IndexWidth));
+    Add(Recording.Text);
+
+    for (const auto& Name : Recording.Identifiers) {
+        std::string Signature = Name + ":";
+        raw_string_ostream OS(Signature);
+        if (Function* F = TheModule->getFunction(Name)) {
+            OS << " fn ";
+            F->getFunctionType()->print(OS);
         }
+        auto GlobalIt = GlobalValues.find(Name);
+        if (GlobalIt != GlobalValues.end() && GlobalIt->second) {
+            OS << " global ";
+            GlobalIt->second->getValueType()->print(OS);
+        }
+        Add(OS.str());
     }
 
-    if (Op == "!") {
-        DEBUG_CODEGEN("  Creating logical NOT");
-        // Logical NOT allows narrowing (like conditionals) per MiniC spec
-        OperandV = castToType(OperandV, Type::getInt1Ty(TheContext), true, "logical NOT operand");
-        if (!OperandV) {
-            return LogErrorV("Failed to convert operand to boolean for '!' operator");
+    MD5::MD5Result Result;
+    Hasher.final(Result);
+    return Result.digest().str().str();
+}
+
+// codegenFunctionWithCache - On a hit only the prototype is emitted now and the cached
+// optimized body is linked in after parsing; on a miss the function is generated normally
+static Value* codegenFunctionWithCache(FunctionDeclAST& FD, const TokenRecording& Recording) {
+    PhaseTimer Timer(CompilePhase::IRGen);
+    const std::string& Name = FD.getName();
+    std::string Path = Opts.FunctionCacheDir + "/" + computeFunctionCacheKey(Recording) + ".bc";
+
+    if (sys::fs::exists(Path)) {
+        if (auto Buffer = MemoryBuffer::getFile(Path)) {
+            Expected<std::unique_ptr<Module>> Cached =
+                parseBitcodeFile((*Buffer)->getMemBufferRef(), TheContext);
+            if (!Cached) {
+                consumeError(Cached.takeError());
+            } else if (Function* CachedF = (*Cached)->getFunction(Name);
+                       CachedF && !CachedF->isDeclaration()) {
+                if (!FD.getProto().codegen())
+                    return nullptr;
+                DEBUG_CODEGEN("Function cache hit: " + Name);
+                FunctionCacheEntries.push_back({Name, Path, std::move(*Cached)});
+                return TheModule->getFunction(Name);
+            }
         }
-        return Builder.CreateNot(OperandV, "not");
     }
 
-    LogCompilerError(ErrorType::SEMANTIC_OTHER,
-                    "Unknown unary operator: '" + Op + "'");
-    return nullptr;
+    DEBUG_CODEGEN("Function cache miss: " + Name);
+    Value* F = FD.codegen();
+    if (F)
+        FunctionCacheEntries.push_back({Name, Path, nullptr});
+    return F;
 }
 
-// AssignmentExprAST::codegen - Generate code for assignments
-Value* AssignmentExprAST::codegen() {
-    DEBUG_CODEGEN("Generating assignment to: " + VarName);
+//===----------------------------------------------------------------------===//
+// Code Generation - AST Node Implementations
+//===----------------------------------------------------------------------===//
 
-    Value* Val = RHS->codegen();
-    if (!Val) {
-        DEBUG_CODEGEN("  ERROR: Failed to generate RHS");
-        return nullptr;
-    }
+// IntASTnode::codegen - Generate LLVM IR for integer literals
+
+//==============================================================================
+// CODE GENERATION
+// LLVM IR generation for all AST nodes
+// Uses LLVM IRBuilder to generate SSA form intermediate representation
+//==============================================================================
+
+Value* IntASTnode::codegen() {
+    DEBUG_CODEGEN("Generating integer literal: " + std::to_string(Val));
+    return ConstantInt::get(Type::getInt32Ty(TheContext), APInt(32, Val, true));
+}
 
-    DEBUG_VERBOSE("  RHS type: " + getTypeName(Val->getType()));
+// FloatASTnode::codegen - Generate LLVM IR for float literals
+Value* FloatASTnode::codegen() {
+    DEBUG_CODEGEN("Generating float literal: " + std::to_string(Val));
+    return ConstantFP::get(Type::getFloatTy(TheContext), APFloat((float)Val));
+}
+
+// BoolASTnode::codegen - Generate LLVM IR for boolean literals
+Value* BoolASTnode::codegen() {
+    DEBUG_CODEGEN("Generating boolean literal: " + std::string(Bool ? "true" : "false"));
+    return ConstantInt::get(Type::getInt1Ty(TheContext), APInt(1, Bool ? 1 : 0, false));
+}
+
+// VariableASTnode::codegen - Generate LLVM IR for variable references
+Value* VariableASTnode::codegen() {
+    DEBUG_CODEGEN("Loading variable: " + Name);
+    return Builder.CreateLoad(ResolvedType->LLVMTy, lookupVariableAddress(Name), Name.c_str());
+}
+
+// BinaryExprAST::codegen - Generate code for binary operators
+Value* BinaryExprAST::codegen() {
+    DEBUG_CODEGEN("Generating binary expression: " + Op);
+
+    Value* L = LHS->codegen();
+    Value* R = RHS->codegen();
 
-    AllocaInst* Variable = NamedValues[VarName];
+    // Promote both operands to the type sema chose (bool for && and ||)
+    L = emitConversion(L, LHS->getResolvedType(), OperandType);
+    R = emitConversion(R, RHS->getResolvedType(), OperandType);
+    bool IsFloat = OperandType->Scalar == MiniCType::Float;
+    // Signed overflow is undefined, as in C, unless -fwrapv asks for wrapping
+    bool NSW = !Opts.WrapV;
+
+    if (Op == "+")
+        return IsFloat ? Builder.CreateFAdd(L, R, "fadd") : Builder.CreateAdd(L, R, "add", false, NSW);
+    if (Op == "-")
+        return IsFloat ? Builder.CreateFSub(L, R, "fsub") : Builder.CreateSub(L, R, "sub", false, NSW);
+    if (Op == "*")
+        return IsFloat ? Builder.CreateFMul(L, R, "fmul") : Builder.CreateMul(L, R, "mul", false, NSW);
+    if (Op == "/")
+        return IsFloat ? Builder.CreateFDiv(L, R, "fdiv") : Builder.CreateSDiv(L, R, "sdiv");
+    if (Op == "%")
+        return Builder.CreateSRem(L, R, "mod");
+    if (Op == "<")
+        return IsFloat ? Builder.CreateFCmpOLT(L, R, "flt") : Builder.CreateICmpSLT(L, R, "lt");
+    if (Op == "<=")
+        return IsFloat ? Builder.CreateFCmpOLE(L, R, "fle") : Builder.CreateICmpSLE(L, R, "le");
+    if (Op == ">")
+        return IsFloat ? Builder.CreateFCmpOGT(L, R, "fgt") : Builder.CreateICmpSGT(L, R, "gt");
+    if (Op == ">=")
+        return IsFloat ? Builder.CreateFCmpOGE(L, R, "fge") : Builder.CreateICmpSGE(L, R, "ge");
+    if (Op == "==")
+        return IsFloat ? Builder.CreateFCmpOEQ(L, R, "feq") : Builder.CreateICmpEQ(L, R, "eq");
+    if (Op == "!=")
+        return IsFloat ? Builder.CreateFCmpONE(L, R, "fne") : Builder.CreateICmpNE(L, R, "ne");
+    if (Op == "&&")
+        return Builder.CreateAnd(L, R, "and");
+    return Builder.CreateOr(L, R, "or");
+}
 
-    if (!Variable) {
-        GlobalVariable* GV = GlobalValues[VarName];
-        if (!GV) {
-            DEBUG_CODEGEN("  ERROR: Variable not found");
-            DUMP_SYMBOL_TABLE();
-            return LogScopeError(VarName, CurrentContext.toString());
-        }
+// UnaryExprAST::codegen - Generate code for unary operators
+Value* UnaryExprAST::codegen() {
+    DEBUG_CODEGEN("Generating unary expression: " + Op);
 
-        DEBUG_CODEGEN("  Assigning to global variable");
-        Type* VarType = GV->getValueType();
-        DEBUG_VERBOSE("  Expected type: " + getTypeName(VarType));
-
-        if (Val->getType() != VarType) {
-            Type* OrigType = Val->getType();
-            Val = castToType(Val, VarType, false, "assignment to global '" + VarName + "'");
-            if (!Val) {
-                DEBUG_CODEGEN("  ERROR: Type conversion failed");
-                return LogTypeError("Type mismatch in assignment to global '" + VarName + "'",
-                                   VarType, OrigType);
-            }
-            DEBUG_VERBOSE("  Type converted from " + getTypeName(OrigType) +
-                         " to " + getTypeName(VarType));
-        }
+    Value* OperandV = Operand->codegen();
 
-        Builder.CreateStore(Val, GV);
-        DEBUG_CODEGEN("  Assignment successful");
-        return Val;
+    if (Op == "-") {
+        if (ResolvedType->Scalar == MiniCType::Float)
+            return Builder.CreateFNeg(OperandV, "fneg");
+        return Opts.WrapV ? Builder.CreateNeg(OperandV, "neg") : Builder.CreateNSWNeg(OperandV, "neg");
     }
 
-    DEBUG_CODEGEN("  Assigning to local variable");
-    Type* VarType = Variable->getAllocatedType();
-    DEBUG_VERBOSE("  Expected type: " + getTypeName(VarType));
+    OperandV = emitConversion(OperandV, Operand->getResolvedType(), ResolvedType);
+    return Builder.CreateNot(OperandV, "not");
+}
 
-    if (Val->getType() != VarType) {
-        Type* OrigType = Val->getType();
-        Val = castToType(Val, VarType, false, "assignment to local '" + VarName + "'");
-        if (!Val) {
-            DEBUG_CODEGEN("  ERROR: Type conversion failed");
-            return LogTypeError("Type mismatch in assignment to local '" + VarName + "'",
-                               VarType, OrigType);
-        }
-        DEBUG_VERBOSE("  Type converted from " + getTypeName(OrigType) +
-                     " to " + getTypeName(VarType));
-    }
+// AssignmentExprAST::codegen - Generate code for assignments
+Value* AssignmentExprAST::codegen() {
+    DEBUG_CODEGEN("Generating assignment to: " + VarName);
 
-    Builder.CreateStore(Val, Variable);
-    DEBUG_CODEGEN("  Assignment successful");
+    Value* Val = emitConversion(RHS->codegen(), RHS->getResolvedType(), ResolvedType);
+    Builder.CreateStore(Val, lookupVariableAddress(VarName));
     return Val;
 }
 
 // CallExprAST::codegen - Generate code for function calls
 Value* CallExprAST::codegen() {
     DEBUG_CODEGEN("Generating function call: " + Callee);
+    if (Builtin != BuiltinKind::None)
+        return codegenBuiltin();
 
-    // Check if function exists
-    Function* CalleeF = checkFunctionExists(Callee);
-    if (!CalleeF) {
-        // Error already logged
-        return nullptr;
-    }
+    Function* CalleeF = TheModule->getFunction(Callee);
 
-    DEBUG_VERBOSE("  Function signature: " + getTypeName(CalleeF->getFunctionType()));
-    DEBUG_VERBOSE("  Expected args: " + std::to_string(CalleeF->arg_size()));
-    DEBUG_VERBOSE("  Provided args: " + std::to_string(Args.size()));
+    std::vector<Value*> ArgsV;
+    for (size_t Idx = 0; Idx < Args.size(); Idx++)
+        ArgsV.push_back(emitConversion(Args[Idx]->codegen(), Args[Idx]->getResolvedType(),
+                                       ParamTypes[Idx]));
+
+    CallInst* Call = CalleeF->getReturnType()->isVoidTy()
+                         ? Builder.CreateCall(CalleeF, ArgsV)
+                         : Builder.CreateCall(CalleeF, ArgsV, "calltmp");
+    Call->setCallingConv(CalleeF->getCallingConv());
+    return Call;
+}
 
-    // Check argument count
-    if (CalleeF->arg_size() != Args.size()) {
-        DEBUG_CODEGEN("  ERROR: Argument count mismatch");
-        std::string msg = "Function '" + Callee + "' expects " +
-                         std::to_string(CalleeF->arg_size()) + " argument(s), but " +
-                         std::to_string(Args.size()) + " provided";
-        LogCompilerError(ErrorType::SEMANTIC_TYPE, msg);
+// CallExprAST::codegenBuiltin - Lower a builtin to the LLVM vector reduction intrinsics
+Value* CallExprAST::codegenBuiltin() {
+    switch (Builtin) {
+    case BuiltinKind::Fill:
+    case BuiltinKind::Copy:
+    case BuiltinKind::Sum:
+    case BuiltinKind::Dot:
+        return codegenBulkBuiltin();
+    default:
+        break;
+    }
+
+    Value* Vec = Args[0]->codegen();
+    bool IsFloat = ResolvedType->Scalar == MiniCType::Float;
+
+    switch (Builtin) {
+    case BuiltinKind::HSum:
+        // -0.0 is the identity of fadd; without reassociation the lanes are summed in order
+        if (IsFloat)
+            return Builder.CreateFAddReduce(ConstantFP::getNegativeZero(ResolvedType->LLVMTy), Vec);
+        return Builder.CreateAddReduce(Vec);
+    case BuiltinKind::HMin:
+        // Float reductions follow minnum/maxnum: a NaN lane is ignored
+        return IsFloat ? Builder.CreateFPMinReduce(Vec) : Builder.CreateIntMinReduce(Vec, true);
+    case BuiltinKind::HMax:
+        return IsFloat ? Builder.CreateFPMaxReduce(Vec) : Builder.CreateIntMaxReduce(Vec, true);
+    default:
         return nullptr;
     }
+}
 
-    std::vector<Value*> ArgsV;
-    unsigned Idx = 0;
+// Elements per iteration of the loops fill, sum and dot are lowered to
+static const unsigned BulkVectorLanes = 8;
+
+// emitArrayBase - Address of the first element of an array variable or array parameter,
+// and the alignment it is known to have
+static Value* emitArrayBase(ASTnode& Arg, const MiniCType* Type, Align& BaseAlign) {
+    const std::string& Name = static_cast<VariableASTnode&>(Arg).getName();
+    Value* Addr = lookupVariableAddress(Name);
+    BaseAlign = TheModule->getDataLayout().getABITypeAlign(Type->ElementTy);
+    if (Type->isPointer()) {
+        auto It = ParamAligns.find(Addr);
+        if (It != ParamAligns.end())
+            BaseAlign = std::max(BaseAlign, It->second);
+        return loadArrayParam(Name, Addr, Type);
+    }
+    if (auto* Alloca = dyn_cast<AllocaInst>(Addr))
+        BaseAlign = std::max(BaseAlign, Alloca->getAlign());
+    else if (auto* GV = dyn_cast<GlobalVariable>(Addr))
+        BaseAlign = std::max(BaseAlign, GV->getAlign().valueOrOne());
+    return Addr;
+}
 
-    for (auto &Arg : Args) {
-        DEBUG_VERBOSE("  Generating argument " + std::to_string(Idx));
+// elementCount - Number of elements of an array type, over all dimensions
+static uint64_t elementCount(const MiniCType* T) {
+    uint64_t Count = 1;
+    for (int Dim : T->Dims) Count *= Dim;
+    return Count;
+}
 
-        Value* ArgVal = Arg->codegen();
-        if (!ArgVal)
-            return nullptr;
+// emitCountedLoop - Emit a loop running Body for i = Begin, Begin + Step, ... while
+// i < End (i64, signed). Carried values are threaded through the iterations: Body gets
+// i and their current values and returns the next ones. Returns their values after
+// the loop, which are the initial ones when it runs no iteration.
+template <typename BodyFn>
+static std::vector<Value*> emitCountedLoop(Value* Begin, Value* End, unsigned Step,
+                                           const std::vector<Value*>& Carried, BodyFn Body) {
+    Function* TheFunction = Builder.GetInsertBlock()->getParent();
+    BasicBlock* Preheader = Builder.GetInsertBlock();
+    BasicBlock* LoopBB = BasicBlock::Create(TheContext, "bulk.loop", TheFunction);
+    BasicBlock* ExitBB = BasicBlock::Create(TheContext, "bulk.exit", TheFunction);
+    Builder.CreateCondBr(Builder.CreateICmpSLT(Begin, End, "bulk.guard"), LoopBB, ExitBB);
 
-        Type* ExpectedType = CalleeF->getFunctionType()->getParamType(Idx);
-        Type* ActualType = ArgVal->getType();
-
-        DEBUG_VERBOSE("    Expected: " + getTypeName(ExpectedType));
-        DEBUG_VERBOSE("    Actual: " + getTypeName(ActualType));
-
-        // Check type compatibility and convert if needed
-        if (ActualType != ExpectedType) {
-            // Per spec: allow widening, disallow narrowing
-            if (isNarrowingConversion(ActualType, ExpectedType)) {
-                std::string msg = "Narrowing conversion in argument " + std::to_string(Idx + 1) +
-                                " of function '" + Callee + "'";
-                msg += "\n  Expected: " + getTypeName(ExpectedType);
-                msg += "\n  Provided: " + getTypeName(ActualType);
-                LogCompilerError(ErrorType::SEMANTIC_TYPE, msg);
-                return nullptr;
-            }
+    Builder.SetInsertPoint(LoopBB);
+    PHINode* I = Builder.CreatePHI(Begin->getType(), 2, "bulk.i");
+    I->addIncoming(Begin, Preheader);
+    std::vector<PHINode*> Phis;
+    for (Value* V : Carried) {
+        Phis.push_back(Builder.CreatePHI(V->getType(), 2, "bulk.acc"));
+        Phis.back()->addIncoming(V, Preheader);
+    }
+
+    std::vector<Value*> Next = Body(I, std::vector<Value*>(Phis.begin(), Phis.end()));
+    // End is at most INT64_MAX rounded down to a multiple of Step, so this cannot wrap
+    Value* INext = Builder.CreateNSWAdd(I, ConstantInt::get(I->getType(), Step), "bulk.next");
+    BasicBlock* Latch = Builder.GetInsertBlock();
+    I->addIncoming(INext, Latch);
+    for (size_t i = 0; i < Phis.size(); i++) Phis[i]->addIncoming(Next[i], Latch);
+    Builder.CreateCondBr(Builder.CreateICmpSLT(INext, End, "bulk.cond"), LoopBB, ExitBB);
+
+    Builder.SetInsertPoint(ExitBB);
+    std::vector<Value*> Results;
+    for (size_t i = 0; i < Carried.size(); i++) {
+        PHINode* Result = Builder.CreatePHI(Carried[i]->getType(), 2, "bulk.result");
+        Result->addIncoming(Carried[i], Preheader);
+        Result->addIncoming(Next[i], Latch);
+        Results.push_back(Result);
+    }
+    return Results;
+}
 
-            ArgVal = castToType(ArgVal, ExpectedType, false,
-                               "function call argument " + std::to_string(Idx + 1));
-            if (!ArgVal) {
-                // Error already logged
-                return nullptr;
-            }
-            DEBUG_VERBOSE("    Converted successfully");
+// CallExprAST::codegenBulkBuiltin - fill lowers to llvm.memset when the value is a byte
+// pattern and copy to llvm.memcpy (llvm.memmove when an array parameter may overlap the
+// other operand). The other cases are loops over BulkVectorLanes elements at a time,
+// sum and dot keeping one partial sum per lane, with a scalar loop for the remainder.
+Value* CallExprAST::codegenBulkBuiltin() {
+    // The module has no target data layout until emission, but the default one sizes
+    // and aligns MiniC's element types the same way
+    const DataLayout& DL = TheModule->getDataLayout();
+    Type* ElemTy = ParamTypes[0]->ElementTy;
+    uint64_t ElemSize = DL.getTypeAllocSize(ElemTy).getFixedValue();
+    Align BaseAlign;
+    Value* Base = emitArrayBase(*Args[0], ParamTypes[0], BaseAlign);
+
+    if (Builtin == BuiltinKind::Copy) {
+        const MiniCType* Sized = ParamTypes[0]->isArray() ? ParamTypes[0] : ParamTypes[1];
+        Align SrcAlign;
+        Value* Src = emitArrayBase(*Args[1], ParamTypes[1], SrcAlign);
+        Value* Bytes = Builder.getInt64(elementCount(Sized) * ElemSize);
+        // Two declared arrays are either the same one or disjoint
+        if (ParamTypes[0]->isArray() && ParamTypes[1]->isArray())
+            Builder.CreateMemCpy(Base, BaseAlign, Src, SrcAlign, Bytes);
+        else
+            Builder.CreateMemMove(Base, BaseAlign, Src, SrcAlign, Bytes);
+        return nullptr;
+    }
+
+    if (Builtin == BuiltinKind::Fill) {
+        uint64_t Count = elementCount(ParamTypes[0]);
+        Value* V = emitConversion(Args[1]->codegen(), Args[1]->getResolvedType(), ParamTypes[1]);
+
+        // Zero, and any bool (stored as one byte), is a byte pattern
+        bool Zero = isa<Constant>(V) && cast<Constant>(V)->isNullValue();
+        if (Zero || V->getType()->isIntegerTy(1)) {
+            Value* Byte = Zero ? Builder.getInt8(0) : Builder.CreateZExt(V, Builder.getInt8Ty(), "fillbyte");
+            Builder.CreateMemSet(Base, Byte, Builder.getInt64(Count * ElemSize), BaseAlign);
+            return nullptr;
         }
 
-        ArgsV.push_back(ArgVal);
-        Idx++;
+        // Arrays of vectors are already filled a whole vector at a time
+        unsigned Width = ParamTypes[1]->isVector() ? 1 : BulkVectorLanes;
+        uint64_t VecEnd = Count - Count % Width;
+        // Each store is aligned like the array at a multiple of its loop step
+        auto Store = [&](Value* Fill, unsigned Step) {
+            Align StoreAlign = commonAlignment(BaseAlign, Step * ElemSize);
+            return [&, Fill, StoreAlign](Value* I, const std::vector<Value*>&) {
+                Builder.CreateAlignedStore(Fill, Builder.CreateGEP(ElemTy, Base, I, "fillptr"), StoreAlign);
+                return std::vector<Value*>();
+            };
+        };
+        if (VecEnd) {
+            Value* Splat = Width > 1 ? Builder.CreateVectorSplat(Width, V, "fillsplat") : V;
+            emitCountedLoop(Builder.getInt64(0), Builder.getInt64(VecEnd), Width, {}, Store(Splat, Width));
+        }
+        if (VecEnd < Count)
+            emitCountedLoop(Builder.getInt64(VecEnd), Builder.getInt64(Count), 1, {}, Store(V, 1));
+        return nullptr;
     }
 
-    DEBUG_CODEGEN("  Call successful");
+    // sum and dot
+    bool IsFloat = ResolvedType->Scalar == MiniCType::Float;
+    Align OtherAlign;
+    Value* Other = Builtin == BuiltinKind::Dot ? emitArrayBase(*Args[1], ParamTypes[1], OtherAlign) : nullptr;
+    Value* N = emitConversion(Args.back()->codegen(), Args.back()->getResolvedType(), ParamTypes.back());
+    N = Builder.CreateSExt(N, Builder.getInt64Ty(), "count");
+    // A negative count sums nothing; unclamped, vecend would round it down past the array
+    N = Builder.CreateSelect(Builder.CreateICmpSLT(N, Builder.getInt64(0), "count.neg"),
+                             Builder.getInt64(0), N, "count.clamped");
+
+    // Term - Element i, or the product of both arrays' elements for dot, as a Ty load
+    // from a loop stepping Step elements at a time
+    auto Term = [&](Type* Ty, unsigned Step, Value* I) {
+        Value* A = Builder.CreateAlignedLoad(Ty, Builder.CreateGEP(ElemTy, Base, I, "aptr"),
+                                             commonAlignment(BaseAlign, Step * ElemSize), "a");
+        if (!Other)
+            return A;
+        Value* B = Builder.CreateAlignedLoad(Ty, Builder.CreateGEP(ElemTy, Other, I, "bptr"),
+                                             commonAlignment(OtherAlign, Step * ElemSize), "b");
+        return IsFloat ? Builder.CreateFMul(A, B, "fmul") : Builder.CreateMul(A, B, "mul");
+    };
+    auto Accumulate = [&](Type* Ty, unsigned Step) {
+        return [&, Ty, Step](Value* I, const std::vector<Value*>& Acc) {
+            Value* T = Term(Ty, Step, I);
+            return std::vector<Value*>{IsFloat ? Builder.CreateFAdd(Acc[0], T, "fadd")
+                                               : Builder.CreateAdd(Acc[0], T, "add")};
+        };
+    };
 
-    if (CalleeF->getReturnType()->isVoidTy())
-        return Builder.CreateCall(CalleeF, ArgsV);
-    else
-        return Builder.CreateCall(CalleeF, ArgsV, "calltmp");
+    Type* VecTy = FixedVectorType::get(ElemTy, BulkVectorLanes);
+    Value* VecEnd = Builder.CreateAnd(N, Builder.getInt64(-(int64_t)BulkVectorLanes), "vecend");
+    Value* Partial = emitCountedLoop(Builder.getInt64(0), VecEnd, BulkVectorLanes,
+                                     {Constant::getNullValue(VecTy)}, Accumulate(VecTy, BulkVectorLanes))[0];
+
+    // The lanes are independent partial sums, so their order is free to choose
+    Value* Total;
+    if (IsFloat) {
+        CallInst* Reduce = Builder.CreateFAddReduce(ConstantFP::getNegativeZero(ElemTy), Partial);
+        Reduce->setHasAllowReassoc(true);
+        Total = Reduce;
+    } else {
+        Total = Builder.CreateAddReduce(Partial);
+    }
+    return emitCountedLoop(VecEnd, N, 1, {Total}, Accumulate(ElemTy, 1))[0];
 }
 
 // IfExprAST::codegen - Generate code for if/then/else
 Value* IfExprAST::codegen() {
     Value* CondV = Cond->codegen();
-    if (!CondV)
-        return nullptr;
 
     // Convert condition to bool
-    CondV = castToType(CondV, Type::getInt1Ty(TheContext));
+    CondV = emitConversion(CondV, Cond->getResolvedType(), getMiniCType(MiniCType::Bool));
 
     Function* TheFunction = Builder.GetInsertBlock()->getParent();
 
@@ -3882,20 +5152,19 @@ Value* IfExprAST::codegen() {
 
     // Emit then block
     Builder.SetInsertPoint(ThenBB);
-    Value* ThenV = Then->codegen();
-    if (!ThenV)
-        return nullptr;
-    Builder.CreateBr(MergeBB);
+    Then->codegen();
+    // A branch ending in "return" is already terminated
+    if (!Builder.GetInsertBlock()->getTerminator())
+        Builder.CreateBr(MergeBB);
     ThenBB = Builder.GetInsertBlock();
 
     // Emit else block
     if (Else) {
         TheFunction->insert(TheFunction->end(), ElseBB);
         Builder.SetInsertPoint(ElseBB);
-        Value* ElseV = Else->codegen();
-        if (!ElseV)
-            return nullptr;
-        Builder.CreateBr(MergeBB);
+        Else->codegen();
+        if (!Builder.GetInsertBlock()->getTerminator())
+            Builder.CreateBr(MergeBB);
         ElseBB = Builder.GetInsertBlock();
     }
 
@@ -3921,23 +5190,20 @@ Value* WhileExprAST::codegen() {
     // Emit loop header (condition check)
     Builder.SetInsertPoint(LoopBB);
     Value* CondV = Cond->codegen();
-    if (!CondV)
-        return nullptr;
 
     // Convert condition to bool
-    CondV = castToType(CondV, Type::getInt1Ty(TheContext));
+    CondV = emitConversion(CondV, Cond->getResolvedType(), getMiniCType(MiniCType::Bool));
 
     Builder.CreateCondBr(CondV, BodyBB, AfterBB);
 
     // Emit loop body
     TheFunction->insert(TheFunction->end(), BodyBB);
     Builder.SetInsertPoint(BodyBB);
-    Value* BodyV = Body->codegen();
-    if (!BodyV)
-        return nullptr;
+    Body->codegen();
 
     // Branch back to loop header
-    Builder.CreateBr(LoopBB);
+    if (!Builder.GetInsertBlock()->getTerminator())
+        Builder.CreateBr(LoopBB);
 
     // Emit after block
     TheFunction->insert(TheFunction->end(), AfterBB);
@@ -3946,140 +5212,72 @@ Value* WhileExprAST::codegen() {
     return Constant::getNullValue(Type::getInt32Ty(TheContext));
 }
 
+// markTailCall - "return f(...)": mark the call tail, or musttail for direct self
+// recursion (where caller and callee prototypes trivially match). Not legal when
+// the callee may see one of the caller's allocas, e.g. a local array argument.
+static void markTailCall(CallInst* Call) {
+    if (!Opts.SiblingCalls) return;
+
+    for (Value* Arg : Call->args())
+        if (Arg->getType()->isPointerTy() && isa<AllocaInst>(getUnderlyingObject(Arg)))
+            return;
+
+    bool SelfRecursive = Call->getCalledFunction() == Call->getFunction();
+    Call->setTailCallKind(SelfRecursive ? CallInst::TCK_MustTail : CallInst::TCK_Tail);
+    DEBUG_CODEGEN(std::string("  Marked ") + (SelfRecursive ? "musttail" : "tail") + " call to " +
+                  Call->getCalledFunction()->getName().str());
+}
+
 // ReturnAST::codegen - Generate code for return statements
 Value* ReturnAST::codegen() {
     DEBUG_CODEGEN("Generating return statement");
 
-    Function* TheFunction = Builder.GetInsertBlock()->getParent();
-    Type* FuncRetType = TheFunction->getReturnType();
-
-    // Case 1: Void return
-    if (!Val) {
-        if (!FuncRetType->isVoidTy()) {
-            DEBUG_CODEGEN("  ERROR: Non-void function must return a value");
-            return LogErrorV("Non-void function '" +
-                           TheFunction->getName().str() +
-                           "' must return a value");
-        }
-        DEBUG_CODEGEN("  Creating void return");
+    if (!Val)
         return Builder.CreateRetVoid();
-    }
-
-    // Case 2: Value return
-    if (FuncRetType->isVoidTy()) {
-        DEBUG_CODEGEN("  ERROR: Void function cannot return a value");
-        return LogErrorV("Void function '" +
-                       TheFunction->getName().str() +
-                       "' cannot return a value");
-    }
-
-    Value* RetVal = Val->codegen();
-    if (!RetVal)
-        return nullptr;
 
-    Type* RetType = RetVal->getType();
-    DEBUG_VERBOSE("  Return value type: " + getTypeName(RetType));
-    DEBUG_VERBOSE("  Function return type: " + getTypeName(FuncRetType));
-
-    if (RetType != FuncRetType) {
-        // Check if this is a narrowing conversion (NOT ALLOWED per spec)
-        if (isNarrowingConversion(RetType, FuncRetType)) {
-            DEBUG_CODEGEN("  ERROR: Narrowing conversion in return");
-            std::string msg = "Return type mismatch in function '" +
-                            TheFunction->getName().str() +
-                            "' - narrowing conversion not allowed";
-            return LogTypeError(msg, FuncRetType, RetType);
-        }
+    Value* RetVal = emitConversion(Val->codegen(), Val->getResolvedType(), FunctionReturnType);
 
-        // Widening conversion (ALLOWED per spec)
-        DEBUG_VERBOSE("  Applying widening conversion");
-        RetVal = castToType(RetVal, FuncRetType, /*allowNarrowing=*/false);
-        if (!RetVal) {
-            DEBUG_CODEGEN("  ERROR: Type conversion failed");
-            return LogTypeError("Cannot convert return value type",
-                              FuncRetType, RetType);
-        }
-    }
+    if (auto* Call = dyn_cast<CallInst>(RetVal))
+        markTailCall(Call);
 
-    DEBUG_CODEGEN("  Return successful");
     return Builder.CreateRet(RetVal);
 }
 
 // BlockAST::codegen - Generate code for blocks
 Value* BlockAST::codegen() {
     std::map<std::string, AllocaInst*> OldBindings;
-    std::set<std::string> CurrentBlockVars;  // Track variables declared in THIS block
     Function* TheFunction = Builder.GetInsertBlock()->getParent();
 
     // Generate code for local declarations
     for (auto& decl : LocalDecls) {
         const std::string& VarName = decl->getName();
-        const std::string& TypeStr = decl->getType();
-
-        DEBUG_CODEGEN("  Declaring local variable/array: " + VarName + " : " + TypeStr);
-
-        // Check for duplicate declaration in same scope
-        if (CurrentBlockVars.find(VarName) != CurrentBlockVars.end()) {
-            LogCompilerError(ErrorType::SEMANTIC_SCOPE,
-                           "Redeclaration of variable '" + VarName + "' in same scope",
-                           CurTok.lineNo, CurTok.columnNo);
-            return nullptr;
-        }
-        CurrentBlockVars.insert(VarName);
-
-        // Check if shadowing a global variable (allowed)
-        if (GlobalValues.find(VarName) != GlobalValues.end()) {
-            DEBUG_CODEGEN("    Shadowing global variable '" + VarName + "'");
-        }
+        DEBUG_CODEGEN("  Declaring local variable/array: " + VarName + " : " + decl->getType()->Name);
 
         // Save old binding if variable already exists in outer scope (shadowing allowed)
-        if (NamedValues[VarName]) {
-            OldBindings[VarName] = NamedValues[VarName];
-            DEBUG_CODEGEN("    Shadowing local variable from outer scope");
-        }
+        auto It = NamedValues.find(VarName);
+        if (It != NamedValues.end() && It->second)
+            OldBindings[VarName] = It->second;
 
         // Check if this is an array declaration
         if (decl->isArray()) {
-            // Array declaration - call its codegen method
-            DEBUG_CODEGEN("    Processing as array declaration");
-            if (!decl->codegen()) {
-                return nullptr;
-            }
-        } else {
-            // Simple variable declaration
-            DEBUG_CODEGEN("    Processing as simple variable declaration");
-            Type* VarType = getTypeFromString(TypeStr);
-            if (!VarType) {
-                LogCompilerError(ErrorType::SEMANTIC_TYPE,
-                                "Invalid type '" + TypeStr + "' for variable '" + VarName + "'");
-                return nullptr;
-            }
-
-            AllocaInst* Alloca = CreateEntryBlockAlloca(TheFunction, VarName, VarType);
-
-            // Initialize to zero
-            if (VarType->isIntegerTy(32)) {
-                Builder.CreateStore(ConstantInt::get(VarType, 0), Alloca);
-            } else if (VarType->isFloatTy()) {
-                Builder.CreateStore(ConstantFP::get(VarType, 0.0), Alloca);
-            } else if (VarType->isIntegerTy(1)) {
-                Builder.CreateStore(ConstantInt::get(VarType, 0), Alloca);
-            }
-
-            NamedValues[VarName] = Alloca;
-            registerVariable(VarName, TypeStr, false);  // Register in symbol table
+            decl->codegen();
+            continue;
         }
+
+        // Simple variable declaration, initialized to zero unless it is always
+        // written before being read
+        Type* VarType = decl->getType()->LLVMTy;
+        AllocaInst* Alloca = CreateEntryBlockAlloca(TheFunction, VarName, VarType);
+        if (decl->needsZeroInit())
+            Builder.CreateStore(Constant::getNullValue(VarType), Alloca);
+        NamedValues[VarName] = Alloca;
     }
 
     // Generate code for statements
     Value* LastVal = nullptr;
     for (auto& stmt : Stmts) {
-        if (stmt) {  // Check if statement is not null (empty statement)
-            Value* StmtVal = stmt->codegen();
-            if (!StmtVal)
-                return nullptr;
-            LastVal = StmtVal;
-        }
+        if (stmt)  // Check if statement is not null (empty statement)
+            LastVal = stmt->codegen();
     }
 
     // Restore old bindings
@@ -4089,47 +5287,37 @@ Value* BlockAST::codegen() {
 
     // Remove variables that went out of scope
     for (auto& decl : LocalDecls) {
-        if (OldBindings.find(decl->getName()) == OldBindings.end()) {
+        if (OldBindings.find(decl->getName()) == OldBindings.end())
             NamedValues.erase(decl->getName());
-            VariableTypes.erase(decl->getName());
-        }
     }
 
     return LastVal ? LastVal : Constant::getNullValue(Type::getInt32Ty(TheContext));
 }
 
+// addFastMathAttributes - The function attributes clang pairs with the fast-math flags,
+// through which the backend relaxes floating point in the code it generates itself
+static void addFastMathAttributes(Function* F) {
+    const FastMathFlags& FMF = Opts.FPMath;
+    if (FMF.noNaNs())
+        F->addFnAttr("no-nans-fp-math", "true");
+    if (FMF.noInfs())
+        F->addFnAttr("no-infs-fp-math", "true");
+    if (FMF.noSignedZeros())
+        F->addFnAttr("no-signed-zeros-fp-math", "true");
+    if (FMF.approxFunc())
+        F->addFnAttr("approx-func-fp-math", "true");
+    if (FMF.isFast())
+        F->addFnAttr("unsafe-fp-math", "true");
+}
+
 // FunctionDeclAST::codegen - Generate code for function definitions
 Value* FunctionDeclAST::codegen() {
-    // Check if function already exists
-    Function* TheFunction = TheModule->getFunction(Proto->getName());
-
-    if (!TheFunction) {
-        // Create function type
-        Type* RetType = getTypeFromString(Proto->getType());
-        std::vector<Type*> ParamTypes;
-
-        for (auto& param : Proto->getParams()) {
-            ParamTypes.push_back(getTypeFromString(param->getType()));
-        }
+    TimeTraceScope TraceScope("FunctionDeclAST::codegen", Proto->getName());
+    PhaseTimer Timer(CompilePhase::IRGen);
+    FunctionIRGenTimer FunctionTimer(Proto->getName(), Block != nullptr);
 
-        FunctionType* FT = FunctionType::get(RetType, ParamTypes, false);
-        TheFunction = Function::Create(FT, Function::ExternalLinkage,
-                                      Proto->getName(), TheModule.get());
-
-        // Set parameter names
-        unsigned Idx = 0;
-        for (auto& Arg : TheFunction->args()) {
-            Arg.setName(Proto->getParams()[Idx++]->getName());
-        }
-    } else {
-        // Function already exists - check if it already has a body (redefinition)
-        if (!TheFunction->empty()) {
-            LogCompilerError(ErrorType::SEMANTIC_SCOPE,
-                           "Redefinition of function '" + Proto->getName() + "'",
-                           CurTok.lineNo, CurTok.columnNo);
-            return nullptr;
-        }
-    }
+    // Reuses the declaration from an earlier prototype or extern
+    Function* TheFunction = Proto->codegen();
 
     // If this is a forward declaration (no body), just return the prototype
     if (!Block) {
@@ -4147,90 +5335,64 @@ Value* FunctionDeclAST::codegen() {
 
     // Clear variable scope
     NamedValues.clear();
-
-    // Check for duplicate parameter names
-    std::set<std::string> ParamNames;
-    for (auto& param : Proto->getParams()) {
-        const std::string& ParamName = param->getName();
-        if (ParamNames.find(ParamName) != ParamNames.end()) {
-            LogCompilerError(ErrorType::SEMANTIC_SCOPE,
-                           "Duplicate parameter name '" + ParamName + "' in function '" +
-                           Proto->getName() + "'",
-                           CurTok.lineNo, CurTok.columnNo);
-            return nullptr;
-        }
-        ParamNames.insert(ParamName);
-    }
+    ParamAligns.clear();
 
     // Create allocas for parameters
-    unsigned Idx = 0;
     for (auto& Arg : TheFunction->args()) {
         std::string ArgName(Arg.getName());
         AllocaInst* Alloca = CreateEntryBlockAlloca(TheFunction, ArgName, Arg.getType());
         Builder.CreateStore(&Arg, Alloca);
         NamedValues[ArgName] = Alloca;
-        std::string TypeStr = Proto->getParams()[Idx++]->getType();
-        VariableTypes[ArgName] = TypeStr;
-        registerVariable(ArgName, TypeStr, false);  // Register parameter in symbol table
+        if (MaybeAlign ParamAlign = TheFunction->getParamAlign(Arg.getArgNo()))
+            ParamAligns[Alloca] = *ParamAlign;
     }
 
     // Generate function body
-    if (Value* RetVal = Block->codegen()) {
-        // Check if the last block has a terminator
-        if (!Builder.GetInsertBlock()->getTerminator()) {
-            if (TheFunction->getReturnType()->isVoidTy()) {
-                Builder.CreateRetVoid();
-            } else {
-                // For non-void functions, return a default value
-                if (TheFunction->getReturnType()->isIntegerTy(32)) {
-                    Builder.CreateRet(ConstantInt::get(TheFunction->getReturnType(), 0));
-                } else if (TheFunction->getReturnType()->isFloatTy()) {
-                    Builder.CreateRet(ConstantFP::get(TheFunction->getReturnType(), 0.0));
-                } else if (TheFunction->getReturnType()->isIntegerTy(1)) {
-                    Builder.CreateRet(ConstantInt::get(TheFunction->getReturnType(), 0));
-                }
-            }
-        }
+    Block->codegen();
 
-        // Verify function
-        verifyFunction(*TheFunction);
+    // Falling off the end returns void, or zero from a non-void function
+    if (!Builder.GetInsertBlock()->getTerminator()) {
+        Type* RetType = TheFunction->getReturnType();
+        if (RetType->isVoidTy())
+            Builder.CreateRetVoid();
+        else
+            Builder.CreateRet(Constant::getNullValue(RetType));
+    }
 
-        for (auto& param : Proto->getParams()) {
-            SymbolTypeTable.erase(param->getName());
-        }
+    // Declarations must stay external, so linkage is only set once defined
+    if (StaticFunctions.count(Proto->getName()))
+        setInternalLinkage(TheFunction);
+    addFastMathAttributes(TheFunction);
 
-        CurrentFunction = OldFunction;
-        return TheFunction;
+    // Verify function
+    {
+        PhaseTimer VerifyTimer(CompilePhase::Verify);
+        verifyFunction(*TheFunction);
     }
 
-    // Error - remove function
-    TheFunction->eraseFromParent();
     CurrentFunction = OldFunction;
-    return nullptr;
+    return TheFunction;
 }
 
 // Function signature/prototype
 Function* FunctionPrototypeAST::codegen() {
+    PhaseTimer Timer(CompilePhase::IRGen);
+    if (IsStatic)
+        StaticFunctions.insert(getName());
+
     // Check if function already exists
     Function* TheFunction = TheModule->getFunction(getName());
     if (TheFunction) {
+        addParamAlignments(TheFunction);
         return TheFunction;
     }
 
     // Use llvm::Type to avoid conflict with class member 'Type'
-    llvm::Type* RetType = getTypeFromString(getType());
-    if (!RetType) {
-        return LogErrorF("Invalid return type in function prototype");
-    }
+    llvm::Type* RetType = getType()->LLVMTy;
 
     std::vector<llvm::Type*> ParamTypes;
-    for (auto& param : getParams()) {
-        llvm::Type* ParamType = getTypeFromString(param->getType());
-        if (!ParamType) {
-            return LogErrorF("Invalid parameter type in function prototype");
-        }
-        ParamTypes.push_back(ParamType);
-    }
+    for (auto& param : getParams())
+        ParamTypes.push_back(param->getType()->LLVMTy);
 
     FunctionType* FT = FunctionType::get(RetType, ParamTypes, false);
 
@@ -4244,49 +5406,39 @@ Function* FunctionPrototypeAST::codegen() {
         Arg.setName(getParams()[Idx++]->getName());
     }
 
+    addParamAlignments(TheFunction);
     return TheFunction;
 }
 
+// FunctionPrototypeAST::addParamAlignments - aligned(N) on an array parameter promises
+// that every caller passes an array aligned to N bytes
+void FunctionPrototypeAST::addParamAlignments(Function* TheFunction) {
+    for (unsigned Idx = 0; Idx < getParams().size(); Idx++) {
+        if (unsigned Alignment = getParams()[Idx]->getAlignment())
+            TheFunction->addParamAttr(Idx, Attribute::getWithAlignment(TheContext, Align(Alignment)));
+    }
+}
+
 // GlobVarDeclAST::codegen - Generate code for global variable declarations
 Value* GlobVarDeclAST::codegen() {
+    PhaseTimer Timer(CompilePhase::IRGen);
     DEBUG_CODEGEN("Generating global variable: " + getName());
 
-    // Check if variable already exists
-    if (GlobalValues.find(getName()) != GlobalValues.end()) {
-        std::string msg = "Redeclaration of global variable '" + getName() + "'";
-        LogCompilerError(ErrorType::SEMANTIC_SCOPE, msg);
-        return nullptr;
-    }
-
-    llvm::Type* VarType = getTypeFromString(getType());
-    if (!VarType) {
-        return LogErrorV("Invalid type for global variable '" + getName() + "'");
-    }
+    llvm::Type* VarType = getType()->LLVMTy;
 
     // Create global variable with zero initializer
-    Constant* InitVal = nullptr;
-
-    if (VarType->isIntegerTy(32)) {
-        InitVal = ConstantInt::get(VarType, 0);
-    } else if (VarType->isFloatTy()) {
-        InitVal = ConstantFP::get(VarType, 0.0);
-    } else if (VarType->isIntegerTy(1)) {
-        InitVal = ConstantInt::get(VarType, 0);
-    } else {
-        return LogErrorV("Unsupported type for global variable '" + getName() + "'");
-    }
-
     GlobalVariable* GV = new GlobalVariable(
         *TheModule,
         VarType,
         false,
         GlobalValue::CommonLinkage,
-        InitVal,
+        Constant::getNullValue(VarType),
         getName()
     );
+    if (IsStatic)
+        setInternalLinkage(GV);
 
     GlobalValues[getName()] = GV;
-    registerVariable(getName(), getType(), true);  // Register in symbol table
 
     DEBUG_CODEGEN("  Global variable created successfully");
     return GV;
@@ -4294,28 +5446,13 @@ Value* GlobVarDeclAST::codegen() {
 
 // ArrayDeclAST::codegen - Generate code for array declarations
 Value* ArrayDeclAST::codegen() {
+    PhaseTimer Timer(CompilePhase::IRGen);
     DEBUG_CODEGEN("Generating array declaration: " + getName());
 
-    // Get base element type
-    llvm::Type* BaseType = getTypeFromString(Type);
-    if (!BaseType) {
-        return LogErrorV("Invalid type '" + Type + "' for array '" + getName() + "'");
-    }
-
-    // Build nested array type for multi-dimensional arrays
-    // For int[10][5], we create ArrayType::get(ArrayType::get(i32, 5), 10)
-    // This represents an array of 10 elements, where each element is an array of 5 ints
-    llvm::Type* FullArrayType = BaseType;
-    for (int i = Dimensions.size() - 1; i >= 0; i--) {
-        FullArrayType = llvm::ArrayType::get(FullArrayType, Dimensions[i]);
-        DEBUG_CODEGEN("  Creating array dimension [" + std::to_string(Dimensions[i]) + "]");
-    }
-
-    // Create type string for symbol table (e.g., "int[10][5]")
-    std::string TypeStr = Type;
-    for (size_t i = 0; i < Dimensions.size(); i++) {
-        TypeStr += "[" + std::to_string(Dimensions[i]) + "]";
-    }
+    // Nested array type built by the parser: for int[10][5] this is
+    // [10 x [5 x i32]], an array of 10 elements that are arrays of 5 ints
+    llvm::Type* FullArrayType = Type->LLVMTy;
+    const std::string& TypeStr = Type->Name;
 
     if (IsGlobal) {
         // Global array declaration
@@ -4332,9 +5469,12 @@ Value* ArrayDeclAST::codegen() {
             InitVal,
             getName()
         );
+        if (IsStatic)
+            setInternalLinkage(GV);
+        if (unsigned Requested = getAlignment())
+            GV->setAlignment(std::max(Align(Requested), TheModule->getDataLayout().getABITypeAlign(FullArrayType)));
 
         GlobalValues[getName()] = GV;
-        registerVariable(getName(), TypeStr, true);
 
         DEBUG_CODEGEN("  Global array created successfully");
         return GV;
@@ -4342,298 +5482,744 @@ Value* ArrayDeclAST::codegen() {
         // Local array declaration
         DEBUG_CODEGEN("  Creating local array with type: " + TypeStr);
 
-        if (!CurrentFunction) {
-            return LogErrorV("Array declaration outside of function");
-        }
+        // Allocate array on the stack
+        AllocaInst* Alloca = CreateEntryBlockAlloca(CurrentFunction, getName(), FullArrayType);
+        if (unsigned Requested = getAlignment())
+            Alloca->setAlignment(std::max(Alloca->getAlign(), Align(Requested)));
+
+        // Zero the whole array where some element may be read before it is stored
+        if (needsZeroInit()) {
+            uint64_t Bytes = TheModule->getDataLayout().getTypeAllocSize(FullArrayType);
+            Builder.CreateMemSet(Alloca, Builder.getInt8(0), Builder.getInt64(Bytes), Alloca->getAlign());
+        }
+
+        NamedValues[getName()] = Alloca;
+
+        DEBUG_CODEGEN("  Local array created successfully");
+        return Alloca;
+    }
+}
+
+// emitIndex - Subscript value as i32: float subscripts truncate, bool ones zero-extend
+static Value* emitIndex(ASTnode& Index) {
+    Value* IndexVal = Index.codegen();
+    switch (Index.getResolvedType()->Scalar) {
+    case MiniCType::Float:
+        return Builder.CreateFPToSI(IndexVal, Type::getInt32Ty(TheContext), "floattoint");
+    case MiniCType::Bool:
+        return Builder.CreateZExt(IndexVal, Type::getInt32Ty(TheContext), "booltoint");
+    default:
+        return IndexVal;
+    }
+}
+
+// ASTnode::codegenWideIndex - A subscript as an i64 with --index-width=64, together
+// with bounds on its value. In general it is an i32 subscript sign-extended.
+Value* ASTnode::codegenWideIndex(int64_t& Min, int64_t& Max) {
+    Min = INT32_MIN;
+    Max = INT32_MAX;
+    return Builder.CreateSExt(emitIndex(*this), Builder.getInt64Ty(), "idxprom");
+}
+
+// IntASTnode::codegenWideIndex - A literal is its own bound
+Value* IntASTnode::codegenWideIndex(int64_t& Min, int64_t& Max) {
+    Min = Max = Val;
+    return Builder.getInt64(Val);
+}
+
+// BinaryExprAST::codegenWideIndex - Integer +, - and * compute on the widened operands,
+// so i * cols + j neither overflows at 2^31 nor needs a sign extension per access.
+// Each operation is nsw as long as the bounds of its operands rule out i64 overflow.
+// With -fwrapv the subscript must wrap at 32 bits, so it is computed as an int.
+Value* BinaryExprAST::codegenWideIndex(int64_t& Min, int64_t& Max) {
+    if (Opts.WrapV || OperandType != getMiniCType(MiniCType::Int) ||
+        (Op != "+" && Op != "-" && Op != "*"))
+        return ASTnode::codegenWideIndex(Min, Max);
+
+    int64_t LMin, LMax, RMin, RMax;
+    Value* L = LHS->codegenWideIndex(LMin, LMax);
+    Value* R = RHS->codegenWideIndex(RMin, RMax);
+
+    bool Overflow;
+    if (Op == "*") {
+        // The extremes of a product are among the products of the operands' extremes
+        int64_t Corners[4];
+        Overflow = MulOverflow(LMin, RMin, Corners[0]) | MulOverflow(LMin, RMax, Corners[1]) |
+                   MulOverflow(LMax, RMin, Corners[2]) | MulOverflow(LMax, RMax, Corners[3]);
+        Min = *std::min_element(Corners, Corners + 4);
+        Max = *std::max_element(Corners, Corners + 4);
+    } else if (Op == "+") {
+        Overflow = AddOverflow(LMin, RMin, Min) | AddOverflow(LMax, RMax, Max);
+    } else {
+        Overflow = SubOverflow(LMin, RMax, Min) | SubOverflow(LMax, RMin, Max);
+    }
+    if (Overflow) {
+        Min = INT64_MIN;
+        Max = INT64_MAX;
+    }
+
+    if (Op == "+")
+        return Builder.CreateAdd(L, R, "idxadd", false, !Overflow);
+    if (Op == "-")
+        return Builder.CreateSub(L, R, "idxsub", false, !Overflow);
+    return Builder.CreateMul(L, R, "idxmul", false, !Overflow);
+}
+
+// emitArrayIndex - A subscript as a GEP index: i32, or i64 with --index-width=64
+static Value* emitArrayIndex(ASTnode& Index) {
+    int64_t Min, Max;
+    return Opts.IndexWidth == 64 ? Index.codegenWideIndex(Min, Max) : emitIndex(Index);
+}
+
+// emitElementGEP - GEP for array subscripts. With --index-width=64 they are inbounds:
+// subscripts must then stay within the array, which lets LLVM fold the address
+// arithmetic of 64-bit indices.
+static Value* emitElementGEP(Type* Ty, Value* Ptr, ArrayRef<Value*> Indices, const Twine& Name) {
+    return Opts.IndexWidth == 64 ? Builder.CreateInBoundsGEP(Ty, Ptr, Indices, Name)
+                                 : Builder.CreateGEP(Ty, Ptr, Indices, Name);
+}
+
+// ArrayAccessAST::codegenAddress - Address of the subscripted element
+Value* ArrayAccessAST::codegenAddress() {
+    Value* ArrayPtr = lookupVariableAddress(Name);
+    std::vector<Value*> IndexValues;
+
+    // A lane of a vector variable lives at the variable itself
+    if (BaseType->isVector())
+        return ArrayPtr;
+
+    if (BaseType->isPointer()) {
+        // Array parameters hold a pointer to the caller's array
+        ArrayPtr = loadArrayParam(Name, ArrayPtr, BaseType);
+    } else {
+        // For regular arrays, first index is always 0 for array-to-pointer decay
+        IndexValues.push_back(ConstantInt::get(Type::getIntNTy(TheContext, Opts.IndexWidth), 0));
+    }
+
+    // The lane subscript, if any, is applied by the caller
+    size_t ArrayIndices = Indices.size() - (LaneAccess ? 1 : 0);
+    for (size_t i = 0; i < ArrayIndices; i++)
+        IndexValues.push_back(emitArrayIndex(*Indices[i]));
+
+    if (!BaseType->isPointer())
+        return emitElementGEP(BaseType->LLVMTy, ArrayPtr, IndexValues, "arrayidx");
+    if (IndexValues.size() == 1)
+        return emitElementGEP(BaseType->ElementTy, ArrayPtr, IndexValues, "arrayidx");
+
+    // Multi-dimensional array parameter - use chained GEPs
+    // First GEP steps over whole rows (e.g., [10 x float]),
+    // each later one over the next inner dimension
+    for (size_t i = 0; i < IndexValues.size(); i++) {
+        ArrayPtr = emitElementGEP(getParamGEPType(BaseType, i), ArrayPtr,
+                                  IndexValues[i], "arrayidx" + std::to_string(i));
+    }
+    return ArrayPtr;
+}
+
+// ArrayAccessAST::codegen - Generate code for array access expressions
+Value* ArrayAccessAST::codegen() {
+    DEBUG_CODEGEN("Generating array access: " + getName());
+    Value* ElementPtr = codegenAddress();
+    if (!LaneAccess)
+        return Builder.CreateLoad(ResolvedType->LLVMTy, ElementPtr, "arrayelem");
+
+    Value* Lane = emitIndex(*Indices.back());
+    Value* Vec = Builder.CreateLoad(BaseType->ElementTy, ElementPtr, "vec");
+    return Builder.CreateExtractElement(Vec, Lane, "lane");
+}
+
+// ArrayAssignmentExprAST::codegen - Generate code for array assignment expressions
+Value* ArrayAssignmentExprAST::codegen() {
+    DEBUG_CODEGEN("Generating array assignment to: " + LHS->getName());
+
+    Value* Val = RHS->codegen();
+    Value* ElementPtr = LHS->codegenAddress();
+    Val = emitConversion(Val, RHS->getResolvedType(), ResolvedType);
+    if (LHS->isLaneAccess()) {
+        // Lanes are not addressable, so the whole vector is rewritten
+        Value* Lane = emitIndex(*LHS->getIndices().back());
+        Value* Vec = Builder.CreateLoad(LHS->getBaseType()->ElementTy, ElementPtr, "vec");
+        Builder.CreateStore(Builder.CreateInsertElement(Vec, Val, Lane, "vecins"), ElementPtr);
+        return Val;
+    }
+    Builder.CreateStore(Val, ElementPtr);
+    return Val;
+}
+
+//===----------------------------------------------------------------------===//
+// AST Printer
+//===----------------------------------------------------------------------===//
+
+// void IntASTnode::display(int tabs) {
+//   printf("%s\n",getType().c_str());
+// }
+
+//==============================================================================
+// BACKEND
+// Optimization pipeline, native object emission and the parallel backend
+//==============================================================================
+
+// Default number of module partitions for --backend-threads. The partition
+// count is deliberately independent of the thread count so that the emitted
+// objects are identical however many workers are used.
+static const unsigned DefaultBackendPartitions = 8;
+
+static OptimizationLevel getOptimizationLevel(unsigned Level) {
+    switch (Level) {
+        case 1: return OptimizationLevel::O1;
+        case 2: return OptimizationLevel::O2;
+        case 3: return OptimizationLevel::O3;
+        default: return OptimizationLevel::O0;
+    }
+}
+
+static CodeGenOptLevel getCodeGenOptLevel(unsigned Level) {
+    switch (Level) {
+        case 0: return CodeGenOptLevel::None;
+        case 1: return CodeGenOptLevel::Less;
+        case 3: return CodeGenOptLevel::Aggressive;
+        default: return CodeGenOptLevel::Default;
+    }
+}
+
+// initializeNativeTarget - Register the host target once before any TargetMachine is created
+static void initializeNativeTarget() {
+    static bool Initialized = false;
+    if (!Initialized) {
+        InitializeNativeTarget();
+        InitializeNativeTargetAsmPrinter();
+        Initialized = true;
+    }
+}
+
+// createHostTargetMachine - Build a TargetMachine for the host triple and CPU
+static std::unique_ptr<TargetMachine> createHostTargetMachine(unsigned OptLevel,
+                                                              std::string& Error) {
+    std::string TargetTriple = sys::getDefaultTargetTriple();
+    const Target* TheTarget = TargetRegistry::lookupTarget(TargetTriple, Error);
+    if (!TheTarget) return nullptr;
+
+    TargetOptions Options;
+    return std::unique_ptr<TargetMachine>(TheTarget->createTargetMachine(
+        Triple(TargetTriple), sys::getHostCPUName(), "", Options, Reloc::PIC_,
+        std::nullopt, getCodeGenOptLevel(OptLevel)));
+}
+
+// configureModuleForTarget - Stamp the target triple and data layout onto a module
+static void configureModuleForTarget(Module& M, TargetMachine& TM) {
+    M.setTargetTriple(TM.getTargetTriple());
+    M.setDataLayout(TM.createDataLayout());
+}
+
+// registerFunctionPassTimers - Charge the time of function passes to the function they
+// ran on. Pass managers and adaptors are passes too, so only the outermost
+// function-level pass on the stack is counted.
+static void registerFunctionPassTimers(PassInstrumentationCallbacks& PIC) {
+    struct RunningPass {
+        TimingClock::time_point Start;
+        bool OnFunction;
+    };
+    auto Stack = std::make_shared<std::vector<RunningPass>>();
+
+    PIC.registerBeforeNonSkippedPassCallback([Stack](StringRef, Any IR) {
+        Stack->push_back({TimingClock::now(), any_cast<const Function*>(&IR) != nullptr});
+    });
+    auto Finish = [Stack](const Function* const* F) {
+        if (Stack->empty()) return;
+        RunningPass Pass = Stack->back();
+        Stack->pop_back();
+        if (!F || !Pass.OnFunction) return;
+        for (const auto& Outer : *Stack)
+            if (Outer.OnFunction) return;
+        FunctionTimeTable[(*F)->getName().str()].OptMs += elapsedMs(Pass.Start, TimingClock::now());
+    };
+    PIC.registerAfterPassCallback([Finish](StringRef, Any IR, const PreservedAnalyses&) {
+        Finish(any_cast<const Function*>(&IR));
+    });
+    PIC.registerAfterPassInvalidatedCallback([Finish](StringRef, const PreservedAnalyses&) {
+        Finish(nullptr);
+    });
+}
+
+// runPassPipeline - Run the pass pipeline made by BuildPipeline with all analyses registered
+template <typename PipelineBuilder>
+static void runPassPipeline(Module& M, TargetMachine* TM, PipelineBuilder BuildPipeline) {
+    PhaseTimer Timer(CompilePhase::Optimize);
+
+    LoopAnalysisManager LAM;
+    FunctionAnalysisManager FAM;
+    CGSCCAnalysisManager CGAM;
+    ModuleAnalysisManager MAM;
+
+    PassInstrumentationCallbacks PIC;
+    if (timingEnabled()) registerFunctionPassTimers(PIC);
+
+    // Gives every pass its own -ftime-trace span
+    StandardInstrumentations SI(M.getContext(), /*DebugLogging=*/false);
+    if (timeTraceProfilerEnabled()) SI.registerCallbacks(PIC, &MAM);
+
+    PassBuilder PB(TM, PipelineTuningOptions(), std::nullopt, &PIC);
+    PB.registerModuleAnalyses(MAM);
+    PB.registerCGSCCAnalyses(CGAM);
+    PB.registerFunctionAnalyses(FAM);
+    PB.registerLoopAnalyses(LAM);
+    PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+    ModulePassManager MPM = BuildPipeline(PB);
+    MPM.run(M, MAM);
+}
+
+// optimizeModule - Run the standard -O<n> module pipeline (no-op at -O0)
+static void optimizeModule(Module& M, TargetMachine* TM, unsigned OptLevel) {
+    if (OptLevel == 0) return;
+    TimeTraceScope TraceScope("Optimize", M.getModuleIdentifier());
+
+    runPassPipeline(M, TM, [&](PassBuilder& PB) {
+        return PB.buildPerModuleDefaultPipeline(getOptimizationLevel(OptLevel));
+    });
+}
+
+// optimizeFunctionsIndividually - Function simplification pipeline only, so the result
+// for each function depends on nothing but its own body (used by the function cache)
+static void optimizeFunctionsIndividually(Module& M, TargetMachine* TM, unsigned OptLevel) {
+    if (OptLevel == 0) return;
+
+    runPassPipeline(M, TM, [&](PassBuilder& PB) {
+        ModulePassManager MPM;
+        MPM.addPass(createModuleToFunctionPassAdaptor(PB.buildFunctionSimplificationPipeline(
+            getOptimizationLevel(OptLevel), ThinOrFullLTOPhase::None)));
+        return MPM;
+    });
+}
+
+// callsItself - True if F contains a direct call to itself
+static bool callsItself(Function& F) {
+    for (User* U : F.users())
+        if (auto* Call = dyn_cast<CallInst>(U))
+            if (Call->getFunction() == &F && Call->getCalledFunction() == &F) return true;
+    return false;
+}
 
-        // Allocate array on the stack
-        AllocaInst* Alloca = CreateEntryBlockAlloca(CurrentFunction, getName(), FullArrayType);
+// SelfRecursionToLoopPass - Tail and accumulator recursion elimination, restricted to
+// self-recursive functions so that the rest of an -O0 module is left untouched.
+// SROA first moves the recursive call's result out of memory, so that a pattern like
+// "result = n + f(n - 1); ... return result;" reaches TailCallElim as "ret (add n, call)",
+// which it rewrites into a loop with an accumulator.
+struct SelfRecursionToLoopPass : PassInfoMixin<SelfRecursionToLoopPass> {
+    PreservedAnalyses run(Function& F, FunctionAnalysisManager& FAM) {
+        if (!callsItself(F)) return PreservedAnalyses::all();
+
+        FunctionPassManager FPM;
+        FPM.addPass(SROAPass(SROAOptions::ModifyCFG));
+        FPM.addPass(TailCallElimPass());
+        FPM.addPass(SimplifyCFGPass());
+        return FPM.run(F, FAM);
+    }
+};
 
-        // Note: We don't initialize arrays to zero explicitly
-        // LLVM will handle proper allocation of the array type
-        // Initialization happens through explicit assignments in the code
+// eliminateSelfRecursion - At -O0, turn deep linear recursion into loops (at -O1 and
+// above the standard pipeline already contains TailCallElim)
+static void eliminateSelfRecursion(Module& M, TargetMachine* TM) {
+    runPassPipeline(M, TM, [&](PassBuilder&) {
+        ModulePassManager MPM;
+        MPM.addPass(createModuleToFunctionPassAdaptor(SelfRecursionToLoopPass()));
+        return MPM;
+    });
+}
 
-        NamedValues[getName()] = Alloca;
-        registerVariable(getName(), TypeStr, false);
+// emitObjectFile - Lower a module to a native relocatable object
+static bool emitObjectFile(Module& M, TargetMachine& TM, const std::string& Filename,
+                           std::string& Error) {
+    std::error_code EC;
+    raw_fd_ostream Dest(Filename, EC, sys::fs::OF_None);
+    if (EC) {
+        Error = "Could not open file '" + Filename + "': " + EC.message();
+        return false;
+    }
 
-        DEBUG_CODEGEN("  Local array created successfully");
-        return Alloca;
+    TimeTraceScope TraceScope("EmitObject", Filename);
+    legacy::PassManager CodeGenPasses;
+    if (TM.addPassesToEmitFile(CodeGenPasses, Dest, nullptr, CodeGenFileType::ObjectFile)) {
+        Error = "Target machine cannot emit an object file";
+        return false;
     }
+
+    CodeGenPasses.run(M);
+    Dest.flush();
+    return true;
 }
 
-// ArrayAccessAST::codegen - Generate code for array access expressions
-Value* ArrayAccessAST::codegen() {
-    DEBUG_CODEGEN("Generating array access: " + getName());
+// getPartitionFileName - "output.o" -> "output.3.o" for partition 3
+static std::string getPartitionFileName(const std::string& Filename, unsigned Index) {
+    size_t Dot = Filename.rfind('.');
+    size_t Slash = Filename.find_last_of('/');
+    if (Dot == std::string::npos || (Slash != std::string::npos && Dot < Slash))
+        return Filename + "." + std::to_string(Index);
+    return Filename.substr(0, Dot) + "." + std::to_string(Index) + Filename.substr(Dot);
+}
 
-    // Look up the array in local scope first, then global scope
-    AllocaInst* ArrayAlloca = NamedValues[getName()];
-    GlobalVariable* ArrayGlobal = nullptr;
-    Value* ArrayPtr = nullptr;
-    Type* BaseType = nullptr;
-    bool isPointerParam = false;
+// runParallelBackend - Split M into partitions and optimize + codegen them concurrently
+//
+// Every partition is serialized to bitcode and re-materialised inside a private
+// LLVMContext on its worker thread, since a context (and everything created in it)
+// must only be touched by one thread at a time. SplitModule assigns globals to
+// partitions by name hash, so the result only depends on the partition count.
+static bool runParallelBackend(Module& M, unsigned Threads, unsigned Partitions,
+                               unsigned OptLevel, bool Optimize, const std::string& Filename,
+                               std::vector<std::string>& OutputFiles) {
+    unsigned NumDefinitions = 0;
+    for (auto& F : M.functions())
+        if (!F.isDeclaration()) NumDefinitions++;
+    Partitions = std::max(1u, std::min(Partitions, NumDefinitions));
+
+    std::vector<SmallString<0>> PartitionBitcode;
+    SplitModule(M, Partitions, [&](std::unique_ptr<Module> MPart) {
+        SmallString<0> Buffer;
+        raw_svector_ostream OS(Buffer);
+        WriteBitcodeToFile(*MPart, OS);
+        PartitionBitcode.push_back(std::move(Buffer));
+    }, /*PreserveLocals=*/true);
+
+    DEBUG_USER("Parallel backend: " + std::to_string(PartitionBitcode.size()) +
+               " partition(s) on " + std::to_string(Threads) + " thread(s)");
+
+    std::vector<std::string> Errors(PartitionBitcode.size());
+    std::atomic<unsigned> NextPartition(0);
+
+    // Each extra worker thread records its own -ftime-trace track
+    const bool Tracing = timeTraceProfilerEnabled();
+    auto Worker = [&](bool ExtraThread) {
+        if (ExtraThread && Tracing)
+            timeTraceProfilerInitialize(Opts.TimeTraceGranularity, "mccomp-backend");
+
+        for (unsigned I = NextPartition++; I < PartitionBitcode.size(); I = NextPartition++) {
+            TimeTraceScope TraceScope("BackendPartition", std::to_string(I));
+            LLVMContext Ctx;
+            MemoryBufferRef Buffer(StringRef(PartitionBitcode[I].data(), PartitionBitcode[I].size()),
+                                   "partition" + std::to_string(I));
+            Expected<std::unique_ptr<Module>> MPart = parseBitcodeFile(Buffer, Ctx);
+            if (!MPart) {
+                Errors[I] = toString(MPart.takeError());
+                continue;
+            }
 
-    if (ArrayAlloca) {
-        DEBUG_CODEGEN("  Found in local scope");
-        ArrayPtr = ArrayAlloca;
-        BaseType = ArrayAlloca->getAllocatedType();
+            std::unique_ptr<TargetMachine> TM = createHostTargetMachine(OptLevel, Errors[I]);
+            if (!TM) continue;
 
-        // Validate that base type is array or pointer (not scalar)
-        if (!BaseType->isArrayTy() && !BaseType->isPointerTy()) {
-            LogCompilerError(ErrorType::SEMANTIC_TYPE,
-                           "Subscript operator [] requires array or pointer type, got scalar",
-                           -1, -1,
-                           "Variable '" + getName() + "' has type: " + getTypeName(BaseType));
-            return nullptr;
+            configureModuleForTarget(**MPart, *TM);
+            if (Optimize)
+                optimizeModule(**MPart, TM.get(), OptLevel);
+            emitObjectFile(**MPart, *TM, getPartitionFileName(Filename, I), Errors[I]);
         }
 
-        // Check if this is a pointer parameter (for array parameters)
-        if (BaseType->isPointerTy()) {
-            DEBUG_CODEGEN("  Detected pointer parameter (array parameter)");
-            isPointerParam = true;
-            // Load the pointer value
-            ArrayPtr = Builder.CreateLoad(BaseType, ArrayAlloca, getName() + "_ptr");
-        }
-    } else {
-        ArrayGlobal = GlobalValues[getName()];
-        if (ArrayGlobal) {
-            DEBUG_CODEGEN("  Found in global scope");
-            ArrayPtr = ArrayGlobal;
-            BaseType = ArrayGlobal->getValueType();
-
-            // Validate that base type is array or pointer (not scalar)
-            if (!BaseType->isArrayTy() && !BaseType->isPointerTy()) {
-                LogCompilerError(ErrorType::SEMANTIC_TYPE,
-                               "Subscript operator [] requires array or pointer type, got scalar",
-                               -1, -1,
-                               "Variable '" + getName() + "' has type: " + getTypeName(BaseType));
-                return nullptr;
-            }
-        } else {
-            return LogErrorV("Unknown array variable: " + getName());
+        if (ExtraThread && Tracing)
+            timeTraceProfilerFinishThread();
+    };
+
+    std::vector<std::thread> Pool;
+    unsigned NumWorkers = std::min<unsigned>(Threads, PartitionBitcode.size());
+    for (unsigned T = 1; T < NumWorkers; T++)
+        Pool.emplace_back(Worker, /*ExtraThread=*/true);
+    Worker(/*ExtraThread=*/false);
+    for (auto& Thread : Pool)
+        Thread.join();
+
+    bool Success = true;
+    for (unsigned I = 0; I < Errors.size(); I++) {
+        if (!Errors[I].empty()) {
+            errs() << "Backend error in partition " << I << ": " << Errors[I] << "\n";
+            Success = false;
         }
+        OutputFiles.push_back(getPartitionFileName(Filename, I));
     }
 
-    // Generate code for all index expressions
-    std::vector<Value*> IndexValues;
+    // An earlier run with more partitions leaves output.N.o files past the last one
+    for (unsigned I = Errors.size(); sys::fs::exists(getPartitionFileName(Filename, I)); I++)
+        sys::fs::remove(getPartitionFileName(Filename, I));
+    return Success;
+}
 
-    if (!isPointerParam) {
-        // For regular arrays, first index is always 0 for array-to-pointer decay
-        IndexValues.push_back(ConstantInt::get(Type::getInt32Ty(TheContext), 0));
+// stripUnusedDeclarations - Drop declarations that nothing in M refers to
+static void stripUnusedDeclarations(Module& M) {
+    for (Function& F : make_early_inc_range(M.functions()))
+        if (F.isDeclaration() && F.use_empty()) F.eraseFromParent();
+    for (GlobalVariable& GV : make_early_inc_range(M.globals()))
+        if (GV.isDeclaration() && GV.use_empty()) GV.eraseFromParent();
+}
+
+// writeFunctionCacheEntry - Store a single-function module, atomically via rename
+static bool writeFunctionCacheEntry(Module& M, const std::string& Path) {
+    int FD;
+    SmallString<128> TmpPath;
+    if (sys::fs::createUniqueFile(Path + ".%%%%%%.tmp", FD, TmpPath))
+        return false;
+    {
+        raw_fd_ostream OS(FD, /*shouldClose=*/true);
+        WriteBitcodeToFile(M, OS);
+    }
+    if (sys::fs::rename(TmpPath, Path)) {
+        sys::fs::remove(TmpPath);
+        return false;
     }
+    return true;
+}
 
-    // Generate code for each subscript expression
-    for (size_t i = 0; i < Indices.size(); i++) {
-        Value* IndexVal = Indices[i]->codegen();
-        if (!IndexVal) {
-            return LogErrorV("Failed to generate code for array index");
+// finalizeFunctionCache - Link cached bodies into M for hits; for misses optimize the
+// function on its own, store it, and swap it in for the unoptimized body
+static bool finalizeFunctionCache(Module& M, TargetMachine* TM) {
+    PhaseTimer Timer(CompilePhase::Optimize);
+    if (std::error_code EC = sys::fs::create_directories(Opts.FunctionCacheDir))
+        errs() << "Warning: cannot create function cache '" << Opts.FunctionCacheDir
+               << "': " << EC.message() << "\n";
+
+    // Cached bodies are linked by name, which only resolves against external symbols:
+    // internal ones are exposed while linking and made internal again afterwards
+    std::set<std::string> InternalNames(StaticFunctions.begin(), StaticFunctions.end());
+    for (GlobalValue& GV : M.global_values()) {
+        if (!GV.hasLocalLinkage()) continue;
+        InternalNames.insert(GV.getName().str());
+        GV.setLinkage(GlobalValue::ExternalLinkage);
+    }
+
+    unsigned Hits = 0, Misses = 0;
+    for (auto& Entry : FunctionCacheEntries) {
+        Function* F = M.getFunction(Entry.Name);
+        if (!F) continue;
+
+        std::unique_ptr<Module> Body = std::move(Entry.CachedBody);
+        if (Body) {
+            Hits++;
+        } else {
+            Misses++;
+            ValueToValueMapTy VMap;
+            Body = CloneModule(M, VMap, [F](const GlobalValue* GV) { return GV == F; });
+            optimizeFunctionsIndividually(*Body, TM, Opts.OptLevel);
+            stripUnusedDeclarations(*Body);
+            if (!writeFunctionCacheEntry(*Body, Entry.Path))
+                DEBUG_USER("Could not write function cache entry " + Entry.Path);
+            if (Opts.OptLevel == 0) continue;  // M already holds exactly this body
+            F->deleteBody();
         }
 
-        // Validate index type - must be integer (int or bool, not float)
-        if (IndexVal->getType()->isFloatTy()) {
-            LogCompilerError(ErrorType::SEMANTIC_TYPE,
-                           "Array index must be integer type, not float",
-                           -1, -1,
-                           "Index " + std::to_string(i) + " for array '" + getName() + "'");
-            return nullptr;
-        } else if (IndexVal->getType()->isIntegerTy(1)) {
-            DEBUG_CODEGEN("  Converting bool index to int");
-            IndexVal = Builder.CreateZExt(IndexVal, Type::getInt32Ty(TheContext), "booltoint");
-        } else if (!IndexVal->getType()->isIntegerTy(32)) {
-            LogCompilerError(ErrorType::SEMANTIC_TYPE,
-                           "Array index must be integer type",
-                           -1, -1,
-                           "Got: " + getTypeName(IndexVal->getType()));
-            return nullptr;
+        if (Linker::linkModules(M, std::move(Body))) {
+            errs() << "Error: could not link cached body of function '" << Entry.Name << "'\n";
+            return false;
         }
-
-        IndexValues.push_back(IndexVal);
-        DEBUG_CODEGEN("  Added index " + std::to_string(i));
     }
 
-    // Determine element type and create GEP
-    Value* GEP = nullptr;
-    Type* ElementType;
+    for (const auto& Name : InternalNames)
+        if (GlobalValue* GV = M.getNamedValue(Name))
+            if (!GV->isDeclaration()) setInternalLinkage(GV);
+
+    fprintf(stderr, "Function cache: %u hit(s), %u miss(es)\n", Hits, Misses);
+    return true;
+}
 
-    if (isPointerParam && IndexValues.size() > 1) {
-        // Multi-dimensional array parameter - use chained GEPs
-        Value* CurrentPtr = ArrayPtr;
+//==============================================================================
+// COMPILE RESULT CACHE
+// Whole-file cache of outputs and diagnostics (--compile-cache, MCCOMP_CACHE_DIR)
+//
+// Each entry is a directory <cache dir>/<key> holding the exit code, captured
+// stdout/stderr and copies of the output files. Entries are published with an
+// atomic rename; the mtime of the "status" file is the LRU timestamp.
+//==============================================================================
 
-        // Extract types from parameter type string stored in VariableTypes
-        std::string paramTypeStr = VariableTypes[getName()];
-        ElementType = getElementTypeFromParamType(paramTypeStr);
-        Type* ArrayTypeForGEP = getArrayTypeForParam(paramTypeStr);
-        DEBUG_CODEGEN("  Multi-dim array param element type: " + paramTypeStr);
+// computeCompileCacheKey - Hash of the source bytes, every option that affects the
+// result and the compiler build; false if the input cannot be read
+static bool computeCompileCacheKey(std::string& Key) {
+    MD5 Hasher;
+    auto Add = [&](StringRef Field) {
+        Hasher.update(Field);
+        Hasher.update(StringRef("\0", 1));
+    };
 
-        // Chain GEPs for each dimension
-        // First GEP uses the array type (e.g., [10 x float])
-        // Subsequent GEPs use the element type
-        for (size_t i = 0; i < IndexValues.size(); i++) {
-            Type* GEPType = (i == 0) ? ArrayTypeForGEP : ElementType;
-            CurrentPtr = Builder.CreateGEP(GEPType, CurrentPtr, IndexValues[i],
-                                          "arrayidx" + std::to_string(i));
-        }
-        GEP = CurrentPtr;
-    } else if (isPointerParam) {
-        // Simple 1D array parameter
-        std::string paramTypeStr = VariableTypes[getName()];
-        ElementType = getElementTypeFromParamType(paramTypeStr);
-        DEBUG_CODEGEN("  1D array param element type: " + paramTypeStr);
-        GEP = Builder.CreateGEP(ElementType, ArrayPtr, IndexValues, "arrayidx");
-    } else {
-        // Regular local/global array
-        Type* GEPType = BaseType;
-        ElementType = BaseType;
-        for (size_t i = 1; i < IndexValues.size(); i++) {
-            if (auto* ArrTy = dyn_cast<llvm::ArrayType>(ElementType)) {
-                ElementType = ArrTy->getElementType();
-            }
-        }
-        GEP = Builder.CreateGEP(GEPType, ArrayPtr, IndexValues, "arrayidx");
-    }
+    Add(getCompilerBuildID());
+    Add(sys::getDefaultTargetTriple());
+    Add(sys::getHostCPUName());
+    for (const auto& Input : Opts.InputFiles) {
+        auto Source = MemoryBuffer::getFile(Input);
+        if (!Source) return false;
+        Add(Input);  // appears in diagnostics
+        Add((*Source)->getBuffer());
+    }
+    if (Opts.Internalize) Add("internalize");
+    if (!Opts.SiblingCalls) Add("no-sibling-calls");
+    if (Opts.WrapV) Add("wrapv");
+    if (Opts.FPMath.any()) Add("fp-math=" + fastMathName());
+    if (Opts.ArrayAlign) Add("array-align=" + std::to_string(Opts.ArrayAlign));
+    if (Opts.IndexWidth != 32) Add("index-width=" + std::to_string(Opts.IndexWidth));
+    if (Opts.LTO) Add("lto");
+    for (const auto& Entry : Opts.EntryPoints) Add(Entry);
+    Add("-O" + std::to_string(Opts.OptLevel));
+    Add(Opts.EmitObject ? "obj" : Opts.EmitBitcode ? "bc" : "ir");
+    Add(Opts.OutputFile);
+    Add(Opts.BackendThreads > 0 ? "partitions=" + std::to_string(Opts.BackendPartitions) : "serial");
+    Add(Opts.FunctionCacheDir.empty() ? "module-opt" : "function-opt");
+    Add("debug=" + std::to_string(static_cast<int>(CurrentDebugLevel)));
+
+    MD5::MD5Result Result;
+    Hasher.final(Result);
+    Key = Result.digest().str().str();
+    return true;
+}
 
-    DEBUG_CODEGEN("  Created GEP");
+// readFileToString - Whole file contents, empty if it cannot be read
+static std::string readFileToString(const std::string& Path) {
+    auto Buffer = MemoryBuffer::getFile(Path);
+    return Buffer ? (*Buffer)->getBuffer().str() : std::string();
+}
 
-    // Load the value at the array element
-    Value* LoadedVal = Builder.CreateLoad(ElementType, GEP, "arrayelem");
+// writeStringToFile - Replace Path with Contents
+static bool writeStringToFile(const std::string& Path, StringRef Contents) {
+    std::error_code EC;
+    raw_fd_ostream OS(Path, EC, sys::fs::OF_None);
+    if (EC) return false;
+    OS << Contents;
+    return true;
+}
 
-    DEBUG_CODEGEN("  Array access code generation completed");
-    return LoadedVal;
+// touchCompileCacheEntry - Mark an entry as most recently used
+static void touchCompileCacheEntry(const std::string& EntryDir) {
+    int FD;
+    if (sys::fs::openFileForWrite(EntryDir + "/status", FD, sys::fs::CD_OpenExisting,
+                                  sys::fs::OF_Append))
+        return;
+    sys::fs::setLastAccessAndModificationTime(
+        FD, std::chrono::time_point_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now()));
+    close(FD);
 }
 
-// ArrayAssignmentExprAST::codegen - Generate code for array assignment expressions
-Value* ArrayAssignmentExprAST::codegen() {
-    DEBUG_CODEGEN("Generating array assignment to: " + LHS->getName());
+// replayCompileCacheEntry - Restore outputs and diagnostics of a cached compilation
+static bool replayCompileCacheEntry(const std::string& Key, int& ExitCode) {
+    std::string EntryDir = Opts.CompileCacheDir + "/" + Key;
+    std::string Status = readFileToString(EntryDir + "/status");
+    if (Status.empty()) return false;
+
+    // Restore every output file before anything is printed, so a partially
+    // evicted entry is treated as a miss rather than replayed halfway
+    std::vector<std::string> Outputs;
+    SmallVector<StringRef, 8> Lines;
+    StringRef(readFileToString(EntryDir + "/outputs")).split(Lines, '\n', -1, false);
+    for (StringRef Line : Lines) Outputs.push_back(Line.str());
+    for (size_t i = 0; i < Outputs.size(); i++) {
+        if (sys::fs::copy_file(EntryDir + "/out" + std::to_string(i), Outputs[i]))
+            return false;
+    }
+
+    std::string Out = readFileToString(EntryDir + "/stdout");
+    std::string Err = readFileToString(EntryDir + "/stderr");
+    fwrite(Out.data(), 1, Out.size(), stdout);
+    fwrite(Err.data(), 1, Err.size(), stderr);
+
+    touchCompileCacheEntry(EntryDir);
+    ExitCode = atoi(Status.c_str());
+    return true;
+}
 
-    // Generate code for the RHS value
-    Value* Val = RHS->codegen();
-    if (!Val) {
-        DEBUG_CODEGEN("  ERROR: Failed to generate RHS");
-        return nullptr;
-    }
+// storeCompileCacheEntry - Publish a finished compilation under Key
+static void storeCompileCacheEntry(const std::string& Key, int ExitCode, const std::string& Out,
+                                   const std::string& Err, const std::vector<std::string>& Outputs) {
+    SmallString<128> TmpDir;
+    if (sys::fs::createUniqueDirectory(Opts.CompileCacheDir + "/" + Key + ".tmp", TmpDir))
+        return;
+    std::string Tmp = TmpDir.str().str();
 
-    // Look up the array (same as ArrayAccessAST but we need the pointer, not the loaded value)
-    AllocaInst* ArrayAlloca = NamedValues[LHS->getName()];
-    GlobalVariable* ArrayGlobal = nullptr;
-    Value* ArrayPtr = nullptr;
-    Type* BaseType = nullptr;
-    bool isPointerParam = false;
-
-    if (ArrayAlloca) {
-        DEBUG_CODEGEN("  Found in local scope");
-        ArrayPtr = ArrayAlloca;
-        BaseType = ArrayAlloca->getAllocatedType();
-
-        // Check if this is a pointer parameter (for array parameters)
-        if (BaseType->isPointerTy()) {
-            DEBUG_CODEGEN("  Detected pointer parameter (array parameter)");
-            isPointerParam = true;
-            // Load the pointer value
-            ArrayPtr = Builder.CreateLoad(BaseType, ArrayAlloca, LHS->getName() + "_ptr");
-        }
-    } else {
-        ArrayGlobal = GlobalValues[LHS->getName()];
-        if (ArrayGlobal) {
-            DEBUG_CODEGEN("  Found in global scope");
-            ArrayPtr = ArrayGlobal;
-            BaseType = ArrayGlobal->getValueType();
-        } else {
-            return LogErrorV("Unknown array variable: " + LHS->getName());
-        }
+    bool Ok = writeStringToFile(Tmp + "/stdout", Out) && writeStringToFile(Tmp + "/stderr", Err);
+    std::string Manifest;
+    for (size_t i = 0; Ok && i < Outputs.size(); i++) {
+        Ok = !sys::fs::copy_file(Outputs[i], Tmp + "/out" + std::to_string(i));
+        Manifest += Outputs[i] + "\n";
     }
+    // "status" is written last: an entry without it is never replayed
+    Ok = Ok && writeStringToFile(Tmp + "/outputs", Manifest) &&
+         writeStringToFile(Tmp + "/status", std::to_string(ExitCode) + "\n");
 
-    // Generate code for all index expressions
-    std::vector<Value*> IndexValues;
+    // Losing the rename race to a concurrent compile of the same input is fine
+    if (!Ok || sys::fs::rename(Tmp, Opts.CompileCacheDir + "/" + Key))
+        sys::fs::remove_directories(Tmp);
+}
 
-    if (!isPointerParam) {
-        // First index is always 0 for array-to-pointer decay
-        IndexValues.push_back(ConstantInt::get(Type::getInt32Ty(TheContext), 0));
-    }
+// evictCompileCache - Remove least recently used entries until the cache fits its size bound
+static void evictCompileCache() {
+    struct CacheEntryInfo {
+        std::string Path;
+        sys::TimePoint<> LastUse;
+        uint64_t Size;
+    };
+    std::vector<CacheEntryInfo> Entries;
+    uint64_t TotalSize = 0;
 
-    // Generate code for each subscript expression
-    for (size_t i = 0; i < LHS->getIndices().size(); i++) {
-        Value* IndexVal = LHS->getIndices()[i]->codegen();
-        if (!IndexVal) {
-            return LogErrorV("Failed to generate code for array index");
+    std::error_code EC;
+    for (sys::fs::directory_iterator It(Opts.CompileCacheDir, EC), End; It != End && !EC;
+         It.increment(EC)) {
+        sys::fs::file_status Status;
+        if (sys::fs::status(It->path() + "/status", Status)) continue;  // incomplete entry
+
+        CacheEntryInfo Entry{It->path(), Status.getLastModificationTime(), 0};
+        std::error_code FileEC;
+        for (sys::fs::directory_iterator File(It->path(), FileEC), FileEnd;
+             File != FileEnd && !FileEC; File.increment(FileEC)) {
+            uint64_t FileSize;
+            if (!sys::fs::file_size(File->path(), FileSize)) Entry.Size += FileSize;
         }
+        TotalSize += Entry.Size;
+        Entries.push_back(std::move(Entry));
+    }
 
-        // Ensure index is an integer (cast if necessary)
-        if (IndexVal->getType()->isFloatTy()) {
-            DEBUG_CODEGEN("  Converting float index to int");
-            IndexVal = Builder.CreateFPToSI(IndexVal, Type::getInt32Ty(TheContext), "floattoint");
-        } else if (IndexVal->getType()->isIntegerTy(1)) {
-            DEBUG_CODEGEN("  Converting bool index to int");
-            IndexVal = Builder.CreateZExt(IndexVal, Type::getInt32Ty(TheContext), "booltoint");
-        } else if (!IndexVal->getType()->isIntegerTy(32)) {
-            return LogErrorV("Array index must be an integer");
-        }
+    const uint64_t Limit = Opts.CompileCacheSizeMB * 1024 * 1024;
+    if (TotalSize <= Limit) return;
 
-        IndexValues.push_back(IndexVal);
-        DEBUG_CODEGEN("  Added index " + std::to_string(i));
+    std::sort(Entries.begin(), Entries.end(), [](const CacheEntryInfo& A, const CacheEntryInfo& B) {
+        return A.LastUse < B.LastUse;
+    });
+    for (const auto& Entry : Entries) {
+        if (TotalSize <= Limit) break;
+        sys::fs::remove_directories(Entry.Path);
+        TotalSize -= Entry.Size;
     }
+}
 
-    // Determine element type and create GEP
-    Value* GEP = nullptr;
-    Type* ElementType;
-
-    if (isPointerParam && IndexValues.size() > 1) {
-        // Multi-dimensional array parameter - use chained GEPs
-        Value* CurrentPtr = ArrayPtr;
-        std::string paramTypeStr = VariableTypes[LHS->getName()];
-        ElementType = getElementTypeFromParamType(paramTypeStr);
-        Type* ArrayTypeForGEP = getArrayTypeForParam(paramTypeStr);
+// OutputCapture - Redirects stdout and stderr into temporary files for the cache
+class OutputCapture {
+    int SavedFD[2] = {-1, -1};
+    SmallString<128> Paths[2];
 
-        // Chain GEPs for each dimension
-        // First GEP uses the array type (e.g., [10 x float])
-        // Subsequent GEPs use the element type
-        for (size_t i = 0; i < IndexValues.size(); i++) {
-            Type* GEPType = (i == 0) ? ArrayTypeForGEP : ElementType;
-            CurrentPtr = Builder.CreateGEP(GEPType, CurrentPtr, IndexValues[i],
-                                          "arrayidx" + std::to_string(i));
-        }
-        GEP = CurrentPtr;
-    } else if (isPointerParam) {
-        // Simple 1D array parameter
-        std::string paramTypeStr = VariableTypes[LHS->getName()];
-        ElementType = getElementTypeFromParamType(paramTypeStr);
-        GEP = Builder.CreateGEP(ElementType, ArrayPtr, IndexValues, "arrayidx");
-    } else {
-        // Regular local/global array
-        Type* GEPType = BaseType;
-        ElementType = BaseType;
-        for (size_t i = 1; i < IndexValues.size(); i++) {
-            if (auto* ArrTy = dyn_cast<llvm::ArrayType>(ElementType)) {
-                ElementType = ArrTy->getElementType();
+public:
+    bool begin() {
+        for (int Stream = 0; Stream < 2; Stream++) {
+            int FD;
+            if (sys::fs::createTemporaryFile("mccomp-capture", "txt", FD, Paths[Stream])) {
+                end();
+                return false;
             }
+            fflush(Stream == 0 ? stdout : stderr);
+            SavedFD[Stream] = dup(Stream + 1);
+            dup2(FD, Stream + 1);
+            close(FD);
         }
-        GEP = Builder.CreateGEP(GEPType, ArrayPtr, IndexValues, "arrayidx");
+        return true;
     }
 
-    DEBUG_CODEGEN("  Created GEP");
-
-    // Type check and cast if necessary (no narrowing allowed)
-    if (Val->getType() != ElementType) {
-        Value* CastedVal = castToType(Val, ElementType, false, "array element assignment");
-        if (!CastedVal) {
-            return LogErrorV("Type mismatch in array assignment");
+    // end - Restore the original streams and return what was written meanwhile
+    void end(std::string* Out = nullptr, std::string* Err = nullptr) {
+        std::cout.flush();
+        outs().flush();
+        fflush(stdout);
+        fflush(stderr);
+        for (int Stream = 0; Stream < 2; Stream++) {
+            if (SavedFD[Stream] >= 0) {
+                dup2(SavedFD[Stream], Stream + 1);
+                close(SavedFD[Stream]);
+                SavedFD[Stream] = -1;
+            }
+            if (Paths[Stream].empty()) continue;
+            std::string* Dest = Stream == 0 ? Out : Err;
+            if (Dest) *Dest = readFileToString(Paths[Stream].str().str());
+            sys::fs::remove(Paths[Stream]);
+            Paths[Stream].clear();
         }
-        Val = CastedVal;
-        DEBUG_CODEGEN("  Type converted for assignment");
     }
-
-    // Store the value to the array element
-    Builder.CreateStore(Val, GEP);
-
-    DEBUG_CODEGEN("  Array assignment successful");
-    return Val;
-}
-
-//===----------------------------------------------------------------------===//
-// AST Printer
-//===----------------------------------------------------------------------===//
-
-// void IntASTnode::display(int tabs) {
-//   printf("%s\n",getType().c_str());
-// }
+};
 
 //===----------------------------------------------------------------------===//
 // Main driver code.
@@ -4659,30 +6245,265 @@ static void cacheSourceLines(const std::string& filename) {
     DEBUG_VERBOSE("Cached " + std::to_string(SourceLines.size()) + " source lines for error reporting");
 }
 
-int main(int argc, char **argv) {
-    initDebugLevel(argc, argv);
-    ShowCompilationProgress();
-
-    std::string inputFile;
+// parseCommandLine - Fill Opts from argv; returns false on a malformed option
+static bool parseCommandLine(int argc, char** argv) {
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
         if (arg == "-d" || arg == "--debug") {
             i++;
             continue;
         }
+        if (arg.size() == 3 && arg[0] == '-' && arg[1] == 'O' && arg[2] >= '0' && arg[2] <= '3') {
+            Opts.OptLevel = arg[2] - '0';
+            continue;
+        }
+        if (arg == "-c") {
+            Opts.EmitObject = true;
+            continue;
+        }
+        if (arg == "-emit-llvm-bc") {
+            Opts.EmitBitcode = true;
+            continue;
+        }
+        if (arg == "-o") {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: -o expects a file name\n");
+                return false;
+            }
+            Opts.OutputFile = argv[++i];
+            continue;
+        }
+        if (arg == "--backend-threads" || arg == "--backend-partitions") {
+            int N = (i + 1 < argc) ? atoi(argv[++i]) : 0;
+            if (N <= 0) {
+                fprintf(stderr, "Error: %s expects a positive integer\n", arg.c_str());
+                return false;
+            }
+            if (arg == "--backend-threads") Opts.BackendThreads = N;
+            else Opts.BackendPartitions = N;
+            continue;
+        }
+        if (arg == "--function-cache" || arg == "--compile-cache") {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: %s expects a directory\n", arg.c_str());
+                return false;
+            }
+            if (arg == "--function-cache") Opts.FunctionCacheDir = argv[++i];
+            else Opts.CompileCacheDir = argv[++i];
+            continue;
+        }
+        if (arg == "--compile-cache-size") {
+            int N = (i + 1 < argc) ? atoi(argv[++i]) : 0;
+            if (N <= 0) {
+                fprintf(stderr, "Error: %s expects a positive integer\n", arg.c_str());
+                return false;
+            }
+            Opts.CompileCacheSizeMB = N;
+            continue;
+        }
+        if (arg == "--lto") {
+            Opts.LTO = true;
+            continue;
+        }
+        if (arg == "--internalize") {
+            Opts.Internalize = true;
+            continue;
+        }
+        if (arg == "-ftime-report") {
+            Opts.TimeReport = true;
+            continue;
+        }
+        if (arg.rfind("-ftime-report-json=", 0) == 0) {
+            Opts.TimeReportFile = arg.substr(strlen("-ftime-report-json="));
+            continue;
+        }
+        if (arg == "-ftime-trace" || arg.rfind("-ftime-trace=", 0) == 0) {
+            Opts.TimeTrace = true;
+            if (arg.size() > strlen("-ftime-trace"))
+                Opts.TimeTraceFile = arg.substr(strlen("-ftime-trace="));
+            continue;
+        }
+        if (arg.rfind("-ftime-trace-granularity=", 0) == 0) {
+            const char* Value = arg.c_str() + strlen("-ftime-trace-granularity=");
+            char* End;
+            long N = strtol(Value, &End, 10);
+            if (End == Value || *End || N < 0 || N > UINT_MAX) {
+                fprintf(stderr, "Error: -ftime-trace-granularity expects a non-negative integer\n");
+                return false;
+            }
+            Opts.TimeTraceGranularity = N;
+            continue;
+        }
+        if (arg.rfind("--array-align=", 0) == 0) {
+            const char* Value = arg.c_str() + strlen("--array-align=");
+            char* End;
+            long N = strtol(Value, &End, 10);
+            if (End == Value || *End || !isValidArrayAlignment(N)) {
+                fprintf(stderr, "Error: --array-align expects a power of two up to %u\n", MaxArrayAlignment);
+                return false;
+            }
+            Opts.ArrayAlign = N;
+            continue;
+        }
+        if (arg.rfind("--index-width=", 0) == 0) {
+            std::string Width = arg.substr(strlen("--index-width="));
+            if (Width != "32" && Width != "64") {
+                fprintf(stderr, "Error: --index-width expects 32 or 64\n");
+                return false;
+            }
+            Opts.IndexWidth = std::stoi(Width);
+            continue;
+        }
+        if (arg == "-fno-optimize-sibling-calls" || arg == "-foptimize-sibling-calls") {
+            Opts.SiblingCalls = arg == "-foptimize-sibling-calls";
+            continue;
+        }
+        if (arg == "-fwrapv" || arg == "-fno-wrapv") {
+            Opts.WrapV = arg == "-fwrapv";
+            continue;
+        }
+        if (arg == "-ffast-math" || arg == "-fno-fast-math") {
+            Opts.FPMath.setFast(arg == "-ffast-math");
+            continue;
+        }
+        if (arg == "-fno-signed-zeros") {
+            Opts.FPMath.setNoSignedZeros();
+            continue;
+        }
+        if (arg == "-freciprocal-math") {
+            Opts.FPMath.setAllowReciprocal();
+            continue;
+        }
+        if (arg == "-fassociative-math") {
+            Opts.FPMath.setAllowReassoc();
+            continue;
+        }
+        if (arg == "--entry") {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --entry expects a function name\n");
+                return false;
+            }
+            SmallVector<StringRef, 4> Names;
+            StringRef(argv[++i]).split(Names, ',', -1, false);
+            for (StringRef Name : Names) Opts.EntryPoints.push_back(Name.str());
+            continue;
+        }
         if (arg[0] != '-') {
-            inputFile = arg;
-            break;
+            Opts.InputFiles.push_back(arg);
+            continue;
         }
+        fprintf(stderr, "Error: unknown option '%s'\n", arg.c_str());
+        return false;
     }
 
-    if (inputFile.empty()) {
-        std::cout << "Usage: ./mccomp [options] InputFile\n";
-        std::cout << "Options:\n";
-        std::cout << "  -d, --debug <level>   Set debug level (user, parser, codegen, verbose)\n";
-        std::cout << "\nOr set MCCOMP_DEBUG environment variable\n";
-        return 1;
+    if (Opts.InputFiles.empty()) return false;
+    Opts.InputFile = Opts.InputFiles.front();
+    if (Opts.InputFiles.size() > 1 && !Opts.LTO) {
+        fprintf(stderr, "Error: multiple input files require --lto\n");
+        return false;
+    }
+    if (Opts.Internalize && Opts.EntryPoints.empty()) {
+        fprintf(stderr, "Error: --internalize needs at least one --entry\n");
+        return false;
+    }
+    if (Opts.LTO) {
+        if (!Opts.FunctionCacheDir.empty()) {
+            fprintf(stderr, "Error: --function-cache cannot be combined with --lto\n");
+            return false;
+        }
+        // Link-time optimization without optimization is pointless
+        if (Opts.OptLevel == 0) Opts.OptLevel = 2;
+    }
+
+    // The parallel backend always produces native code
+    if (Opts.BackendThreads > 0) Opts.EmitObject = true;
+    if (Opts.EmitObject && Opts.EmitBitcode) {
+        fprintf(stderr, "Error: -c and -emit-llvm-bc are mutually exclusive\n");
+        return false;
+    }
+    if (Opts.OutputFile.empty())
+        Opts.OutputFile = Opts.EmitObject ? "output.o" : Opts.EmitBitcode ? "output.bc" : "output.ll";
+    if (Opts.BackendThreads > 0 && Opts.OutputFile == "-") {
+        fprintf(stderr, "Error: --backend-threads writes one object per partition and cannot use -o -\n");
+        return false;
     }
+    if (Opts.BackendPartitions == 0) Opts.BackendPartitions = DefaultBackendPartitions;
+    if (Opts.CompileCacheDir.empty()) {
+        const char* envCache = getenv("MCCOMP_CACHE_DIR");
+        if (envCache) Opts.CompileCacheDir = envCache;
+    }
+    return true;
+}
+
+static void printUsage() {
+    std::cout << "Usage: ./mccomp [options] InputFile\n";
+    std::cout << "       ./mccomp --lto [options] InputFile... (MiniC sources or .bc files)\n";
+    std::cout << "Options:\n";
+    std::cout << "  -d, --debug <level>         Set debug level (user, parser, codegen, verbose)\n";
+    std::cout << "  -O0, -O1, -O2, -O3          Optimization level (default -O0)\n";
+    std::cout << "  -c                          Emit a native object file (output.o) instead of IR\n";
+    std::cout << "  -emit-llvm-bc               Emit LLVM bitcode (output.bc) instead of textual IR\n";
+    std::cout << "  -o <file>                   Write output to <file> ('-' for stdout)\n";
+    std::cout << "  --backend-threads <N>       Optimize and emit module partitions on N threads\n";
+    std::cout << "  --backend-partitions <N>    Number of module partitions (default "
+              << DefaultBackendPartitions << ")\n";
+    std::cout << "  --function-cache <dir>      Reuse optimized IR of unchanged functions\n";
+    std::cout << "  --compile-cache <dir>       Replay results of identical compilations\n";
+    std::cout << "  --compile-cache-size <MB>   Compile cache size bound (default 256)\n";
+    std::cout << "  --lto                       Link all inputs and run link-time optimization\n";
+    std::cout << "                              (implies -O2 unless another level is given)\n";
+    std::cout << "  --entry <name>[,<name>...]  Entry points kept external; others are internalized\n";
+    std::cout << "  --array-align=<N>           Align every array declaration to N bytes\n";
+    std::cout << "  --index-width=<32|64>       Compute array subscripts in 32 (default) or 64 bits\n";
+    std::cout << "  -fno-optimize-sibling-calls Do not mark tail calls or turn recursion into loops\n";
+    std::cout << "  -fwrapv                     Make signed integer overflow wrap instead of undefined\n";
+    std::cout << "  -ffast-math                 Allow every fast-math relaxation of float arithmetic\n";
+    std::cout << "  -fassociative-math          Allow reassociating float arithmetic (reductions)\n";
+    std::cout << "  -freciprocal-math           Allow x / y to become x * (1 / y)\n";
+    std::cout << "  -fno-signed-zeros           Ignore the sign of floating point zeros\n";
+    std::cout << "  -ftime-report               Print time spent per phase and per function\n";
+    std::cout << "  -ftime-report-json=<file>   Write the time report as JSON\n";
+    std::cout << "  -ftime-trace[=<file>]       Write a Chrome trace (default <output>.time-trace)\n";
+    std::cout << "  -ftime-trace-granularity=<us> Minimum span length kept in the trace (default 500)\n";
+    std::cout << "  --internalize               Give every definition except the --entry points\n";
+    std::cout << "                              internal linkage (like declaring them static)\n";
+    std::cout << "\nOr set MCCOMP_DEBUG / MCCOMP_CACHE_DIR environment variables\n";
+}
+
+// resetFrontendState - Forget everything the lexer, parser and code generator know
+// about the previous input, so the next one can be compiled in the same process
+static void resetFrontendState() {
+    TheModule.reset();
+    NamedValues.clear();
+    ParamAligns.clear();
+    GlobalValues.clear();
+    LocalTypes.clear();
+    GlobalTypes.clear();
+    FunctionSignatures.clear();
+    CurrentSignature = nullptr;
+    CurrentFunction = nullptr;
+    SourceLines.clear();
+    CurrentSourceFile.clear();
+    ParserStack.clear();
+    CurrentContext = ParserContext();
+    ErrorLog.clear();
+    HasErrors = false;
+    SymbolTypeTable.clear();
+    SymbolNameIndex.clear();
+    FunctionNameIndex.clear();
+    globalLexeme.clear();
+    LastChar = ' ';
+    NextChar = ' ';
+    CurTok = TOKEN();
+    tok_buffer.clear();
+    ActiveRecording = nullptr;
+    StaticFunctions.clear();
+    FunctionCacheEntries.clear();
+}
+
+// runFrontend - Lex, parse and generate IR for Opts.InputFile into TheModule
+static bool runFrontend() {
+    const std::string& inputFile = Opts.InputFile;
 
     DEBUG_USER("Opening file: " + inputFile);
 
@@ -4692,7 +6513,7 @@ int main(int argc, char **argv) {
     pFile = fopen(inputFile.c_str(), "r");
     if (pFile == NULL) {
         perror("Error opening file");
-        return 1;
+        return false;
     }
 
     lineNo = 1;
@@ -4707,43 +6528,289 @@ int main(int argc, char **argv) {
     ShowPhaseComplete("Lexical analysis");
 
     TheModule = std::make_unique<Module>("mini-c", TheContext);
+    // Every floating point operation codegen creates carries the fast-math flags
+    Builder.setFastMathFlags(Opts.FPMath);
 
     DEBUG_USER("Starting parsing...");
-    parser();
+    {
+        TimeTraceScope TraceScope("Frontend", inputFile);
+        PhaseTimer Timer(CompilePhase::Parsing);
+        parser();
+    }
 
     if (HasErrors) {
         PrintAllErrors();
         fclose(pFile);
-        return 1;
+        return false;
     }
 
     if (CurrentDebugLevel < DebugLevel::PARSER) {
         fprintf(stderr, "Parsing Finished\n");
     }
     ShowPhaseComplete("Parsing");
-    DEBUG_USER("Starting code generation...");
-
-    printf("********************* FINAL IR (begin) ****************************\n");
+    fclose(pFile);
+    return true;
+}
 
-    auto Filename = "output.ll";
-    std::error_code EC;
-    raw_fd_ostream dest(Filename, EC, sys::fs::OF_None);
+// prepareTargetMachine - Target-dependent work (optimization and native code) needs a
+// TargetMachine; TM stays null when neither is requested
+static bool prepareTargetMachine(std::unique_ptr<TargetMachine>& TM) {
+    if (Opts.OptLevel == 0 && !Opts.EmitObject) return true;
 
-    if (EC) {
-        errs() << "Could not open file: " << EC.message();
-        return 1;
+    initializeNativeTarget();
+    std::string Error;
+    TM = createHostTargetMachine(Opts.OptLevel, Error);
+    if (!TM) {
+        errs() << "Could not create target machine: " << Error << "\n";
+        return false;
     }
+    return true;
+}
 
-    TheModule->print(dest, nullptr);
-    printf("********************* FINAL IR (end) ******************************\n");
+// emitOutputs - Optimize M (unless already done) and write it in the requested format
+static bool emitOutputs(Module& M, TargetMachine* TM, bool Optimize,
+                        std::vector<std::string>& OutputFiles) {
+    // The parallel backend's optimization runs on worker threads and counts as emission
+    PhaseTimer Timer(CompilePhase::Emit);
+
+    // Output written to stdout ("-o -") is not a file and is not listed below
+    const std::string& Filename = Opts.OutputFile;
+    const bool ToStdout = Filename == "-";
+
+    if (Opts.BackendThreads > 0) {
+        DEBUG_USER("Starting parallel backend...");
+        if (!runParallelBackend(M, Opts.BackendThreads, Opts.BackendPartitions,
+                                Opts.OptLevel, Optimize, Filename, OutputFiles))
+            return false;
+        ShowPhaseComplete("Parallel backend");
+    } else {
+        if (Optimize && Opts.OptLevel > 0) {
+            DEBUG_USER("Starting optimization (-O" + std::to_string(Opts.OptLevel) + ")...");
+            optimizeModule(M, TM, Opts.OptLevel);
+            ShowPhaseComplete("Optimization");
+        }
 
-    fclose(pFile);
+        if (Opts.EmitObject) {
+            std::string Error;
+            if (!emitObjectFile(M, *TM, Filename, Error)) {
+                errs() << Error << "\n";
+                return false;
+            }
+        } else {
+            DEBUG_USER("Starting code generation...");
+
+            // The banners would corrupt IR or bitcode piped through stdout
+            const bool ShowBanners = !ToStdout && !Opts.EmitBitcode;
+            if (ShowBanners)
+                printf("********************* FINAL IR (begin) ****************************\n");
+
+            // The module is streamed straight into the (buffered) file stream
+            std::error_code EC;
+            raw_fd_ostream dest(Filename, EC, sys::fs::OF_None);
+
+            if (EC) {
+                errs() << "Could not open file: " << EC.message();
+                return false;
+            }
+
+            TimeTraceScope TraceScope(Opts.EmitBitcode ? "EmitBitcode" : "EmitIR", Filename);
+            if (Opts.EmitBitcode)
+                WriteBitcodeToFile(M, dest);
+            else
+                M.print(dest, nullptr);
+            dest.flush();
+            if (ShowBanners)
+                printf("********************* FINAL IR (end) ******************************\n");
+        }
+        if (!ToStdout) OutputFiles.push_back(Filename);
+    }
 
     ShowPhaseComplete("Code generation");
+    return true;
+}
 
+// reportSuccess - Final banner listing every file written
+static void reportSuccess(const std::vector<std::string>& OutputFiles) {
     fprintf(stderr, "\n%s%s✓ Compilation Successful!%s\n",
             COLOR_BOLD, COLOR_GREEN, COLOR_RESET);
-    fprintf(stderr, "Output: output.ll\n\n");
+    for (const auto& OutputFile : OutputFiles)
+        fprintf(stderr, "Output: %s\n", OutputFile.c_str());
+    fprintf(stderr, "\n");
+}
+
+// loadInputModule - Compile a MiniC source, or read a bitcode file, into its own module
+static std::unique_ptr<Module> loadInputModule(const std::string& Input) {
+    if (StringRef(Input).ends_with(".bc")) {
+        auto Buffer = MemoryBuffer::getFile(Input);
+        if (!Buffer) {
+            errs() << "Error: cannot read '" << Input << "': " << Buffer.getError().message() << "\n";
+            return nullptr;
+        }
+        Expected<std::unique_ptr<Module>> M = parseBitcodeFile((*Buffer)->getMemBufferRef(), TheContext);
+        if (!M) {
+            errs() << "Error: invalid bitcode '" << Input << "': " << toString(M.takeError()) << "\n";
+            return nullptr;
+        }
+        return std::move(*M);
+    }
+
+    resetFrontendState();
+    Opts.InputFile = Input;
+    if (!runFrontend()) return nullptr;
+    TheModule->setModuleIdentifier(Input);
+    return std::move(TheModule);
+}
+
+// compileLTO - Link every input into one module, internalize all but the entry
+// points and run the full LTO pipeline, so calls across files can be inlined
+//
+// Each input first goes through the LTO pre-link pipeline on its own, as it would
+// when compiled separately to bitcode.
+static int compileLTO(std::vector<std::string>& OutputFiles) {
+    std::unique_ptr<TargetMachine> TM;
+    if (!prepareTargetMachine(TM)) return 1;
+    const OptimizationLevel Level = getOptimizationLevel(Opts.OptLevel);
+
+    auto Linked = std::make_unique<Module>("mini-c-lto", TheContext);
+    configureModuleForTarget(*Linked, *TM);
+    Linker L(*Linked);
+
+    for (const auto& Input : Opts.InputFiles) {
+        std::unique_ptr<Module> M = loadInputModule(Input);
+        if (!M) return 1;
+
+        configureModuleForTarget(*M, *TM);
+        runPassPipeline(*M, TM.get(), [&](PassBuilder& PB) {
+            return PB.buildLTOPreLinkDefaultPipeline(Level);
+        });
+
+        // Conflicting definitions are reported through the context's diagnostic handler
+        if (L.linkInModule(std::move(M))) {
+            errs() << "Error: could not link '" << Input << "'\n";
+            return 1;
+        }
+    }
+    ShowPhaseComplete("Linking");
 
+    if (Opts.EntryPoints.empty()) {
+        fprintf(stderr, "Warning: no --entry given, all external symbols are preserved\n");
+    } else {
+        std::set<std::string> Keep(Opts.EntryPoints.begin(), Opts.EntryPoints.end());
+        for (const auto& Name : Keep)
+            if (!Linked->getFunction(Name) && !Linked->getNamedGlobal(Name))
+                fprintf(stderr, "Warning: entry point '%s' is not defined\n", Name.c_str());
+        internalizeModule(*Linked, [&](const GlobalValue& GV) {
+            return Keep.count(GV.getName().str()) > 0;
+        });
+    }
+
+    DEBUG_USER("Starting link-time optimization (-O" + std::to_string(Opts.OptLevel) + ")...");
+    TimeTraceScope TraceScope("LTO");
+    runPassPipeline(*Linked, TM.get(), [&](PassBuilder& PB) {
+        return PB.buildLTODefaultPipeline(Level, /*ExportSummary=*/nullptr);
+    });
+    ShowPhaseComplete("Link-time optimization");
+
+    if (!emitOutputs(*Linked, TM.get(), /*Optimize=*/false, OutputFiles)) return 1;
+    reportSuccess(OutputFiles);
+    return 0;
+}
+
+// internalizeNonEntryPoints - --internalize: treat every definition that is not an
+// entry point as if it had been declared static
+static void internalizeNonEntryPoints(Module& M) {
+    std::set<std::string> Keep(Opts.EntryPoints.begin(), Opts.EntryPoints.end());
+    for (GlobalValue& GV : M.global_values())
+        if (!GV.isDeclaration() && !GV.hasLocalLinkage() && !Keep.count(GV.getName().str()))
+            setInternalLinkage(&GV);
+}
+
+// compileInput - Compile the input(s), recording every file written in OutputFiles
+static int compileInput(std::vector<std::string>& OutputFiles) {
+    if (Opts.LTO) return compileLTO(OutputFiles);
+
+    if (!runFrontend()) return 1;
+
+    std::unique_ptr<TargetMachine> TM;
+    if (!prepareTargetMachine(TM)) return 1;
+    if (TM) configureModuleForTarget(*TheModule, *TM);
+
+    if (!Opts.FunctionCacheDir.empty() && !finalizeFunctionCache(*TheModule, TM.get()))
+        return 1;
+
+    if (Opts.Internalize) internalizeNonEntryPoints(*TheModule);
+
+    if (Opts.OptLevel == 0 && Opts.SiblingCalls) eliminateSelfRecursion(*TheModule, TM.get());
+
+    // Functions restored from --function-cache are already optimized
+    if (!emitOutputs(*TheModule, TM.get(), Opts.FunctionCacheDir.empty(), OutputFiles)) return 1;
+    reportSuccess(OutputFiles);
     return 0;
-}
\ No newline at end of file
+}
+
+// compileWithResultCache - Replay a cached result if one exists (before any LLVM
+// target initialization); otherwise compile with output captured and store it
+static int compileWithResultCache() {
+    std::vector<std::string> OutputFiles;
+    std::string Key;
+    if (!computeCompileCacheKey(Key) || sys::fs::create_directories(Opts.CompileCacheDir))
+        return compileInput(OutputFiles);
+
+    int ExitCode;
+    if (replayCompileCacheEntry(Key, ExitCode)) {
+        DEBUG_USER("Compile cache hit: " + Key);
+        return ExitCode;
+    }
+
+    OutputCapture Capture;
+    if (!Capture.begin())
+        return compileInput(OutputFiles);
+    ExitCode = compileInput(OutputFiles);
+    std::string Out, Err;
+    Capture.end(&Out, &Err);
+
+    fwrite(Out.data(), 1, Out.size(), stdout);
+    fwrite(Err.data(), 1, Err.size(), stderr);
+
+    storeCompileCacheEntry(Key, ExitCode, Out, Err, OutputFiles);
+    evictCompileCache();
+    return ExitCode;
+}
+
+int main(int argc, char **argv) {
+    initDebugLevel(argc, argv);
+    ShowCompilationProgress();
+
+    if (!parseCommandLine(argc, argv)) {
+        printUsage();
+        return 1;
+    }
+
+    // Time reports and traces describe a real compilation, never a replayed one
+    if (!Opts.CompileCacheDir.empty() && !timeReportRequested() && !Opts.TimeTrace)
+        return compileWithResultCache();
+
+    if (Opts.TimeTrace)
+        timeTraceProfilerInitialize(Opts.TimeTraceGranularity, "mccomp");
+
+    TimingClock::time_point Start = TimingClock::now();
+    std::vector<std::string> OutputFiles;
+    int ExitCode = compileInput(OutputFiles);
+
+    if (Opts.TimeTrace) {
+        SmallString<128> Fallback(Opts.OutputFile == "-" ? "mccomp" : Opts.OutputFile);
+        sys::path::replace_extension(Fallback, "");
+        if (Error E = timeTraceProfilerWrite(Opts.TimeTraceFile, Fallback)) {
+            errs() << "Warning: cannot write time trace: " << toString(std::move(E)) << "\n";
+            ExitCode = ExitCode ? ExitCode : 1;
+        }
+        timeTraceProfilerCleanup();
+    }
+
+    if (timeReportRequested()) {
+        double TotalMs = elapsedMs(Start, TimingClock::now());
+        if (Opts.TimeReport) printTimeReport(TotalMs);
+        if (!Opts.TimeReportFile.empty()) writeTimeReportJSON(Opts.TimeReportFile, TotalMs);
+    }
+    return ExitCode;
+}
@@ -0,0 +1,18 @@
+// MiniC program using aligned(N) on arrays and array parameters
+
+float table[16] aligned(64);
+
+float scaled_sum(float x[16] aligned(32), int n) {
+  float local[16] aligned(32);
+  copy(local, x);
+  fill(table, 2.0);
+  return dot(local, table, n) + sum(x, n);
+}
+
+int local_sum(int n) {
+  int v[10] aligned(16);
+  int aligned;
+  fill(v, 3);
+  aligned = sum(v, n);
+  return aligned + v[n - 1];
+}
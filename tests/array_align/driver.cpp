@@ -0,0 +1,42 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdint>
+
+// clang++ driver.cpp output.ll -o array_align
+
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+extern "C" DLLEXPORT int print_int(int X) {
+  fprintf(stderr, "%d\n", X);
+  return 0;
+}
+
+extern "C" DLLEXPORT float print_float(float X) {
+  fprintf(stderr, "%f\n", X);
+  return 0;
+}
+
+extern "C" {
+    float table[16];
+    float scaled_sum(float x[16], int n);
+    int local_sum(int n);
+}
+
+int main() {
+    alignas(32) float x[16];
+    for (int i = 0; i < 16; i++) x[i] = i + 1;
+
+    float s = scaled_sum(x, 16);       // 2 * 136 + 136
+    int l = local_sum(10);             // 10 * 3 + 3
+    bool aligned = ((uintptr_t)table & 63) == 0;
+
+    if (s == 408.0f && l == 33 && aligned)
+      std::cout << "PASSED Result: " << s << std::endl;
+    else
+      std::cout << "FAILED Result: " << s << " " << l << " " << aligned << std::endl;
+}
@@ -0,0 +1,24 @@
+// MiniC program passing a three-dimensional array to a function
+
+int cube(int a[2][3][4]) {
+  int i;
+  int j;
+  int k;
+  int total;
+  total = 0;
+  i = 0;
+  while (i < 2) {
+    j = 0;
+    while (j < 3) {
+      k = 0;
+      while (k < 4) {
+        a[i][j][k] = a[i][j][k] + 100 * i + 10 * j + k;
+        total = total + a[i][j][k];
+        k = k + 1;
+      }
+      j = j + 1;
+    }
+    i = i + 1;
+  }
+  return total;
+}
@@ -0,0 +1,43 @@
+#include <iostream>
+#include <cstdio>
+
+// clang++ driver.cpp output.ll -o array_func_arg_3d
+
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+extern "C" DLLEXPORT int print_int(int X) {
+  fprintf(stderr, "%d\n", X);
+  return 0;
+}
+
+extern "C" DLLEXPORT float print_float(float X) {
+  fprintf(stderr, "%f\n", X);
+  return 0;
+}
+
+extern "C" {
+    int cube(int a[2][3][4]);
+}
+
+int main() {
+    int a[2][3][4];
+    for (int i = 0; i < 2; i++)
+      for (int j = 0; j < 3; j++)
+        for (int k = 0; k < 4; k++) a[i][j][k] = 1000;
+
+    // Every element becomes 1000 + 100 * i + 10 * j + k
+    int total = cube(a);
+    bool elements = a[0][0][0] == 1000 && a[0][1][2] == 1012 && a[1][0][3] == 1103 &&
+                    a[1][2][0] == 1120 && a[1][2][3] == 1123;
+
+    if (total == 25476 && elements)
+      std::cout << "PASSED Result: " << total << std::endl;
+    else
+      std::cout << "FAILED Result: " << total << " " << a[0][1][2] << " " << a[1][0][3] << " "
+                << a[1][2][3] << std::endl;
+}
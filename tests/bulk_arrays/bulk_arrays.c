@@ -0,0 +1,42 @@
+// MiniC program using the bulk array builtins fill, copy, sum and dot
+
+int counts[10][10];
+float weights[20];
+bool flags[13];
+
+int reset_counts(int v) {
+  fill(counts, v);
+  counts[9][9] = 1;
+  return sum(counts, 100);
+}
+
+int clear_counts() {
+  fill(counts, 0);
+  return sum(counts, 100);
+}
+
+float weighted(float x[20], int n) {
+  float local[20];
+  fill(weights, 0.5);
+  copy(local, x);
+  return dot(local, weights, n) + sum(x, n);
+}
+
+int idot(int a[12], int n) {
+  return dot(a, a, n);
+}
+
+int count_flags(bool b) {
+  int i;
+  int c;
+  fill(flags, b);
+  i = 0;
+  c = 0;
+  while (i < 13) {
+    if (flags[i]) {
+      c = c + 1;
+    }
+    i = i + 1;
+  }
+  return c;
+}
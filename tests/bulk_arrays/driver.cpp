@@ -0,0 +1,48 @@
+#include <iostream>
+#include <cstdio>
+
+// clang++ driver.cpp output.ll -o bulk_arrays
+
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+extern "C" DLLEXPORT int print_int(int X) {
+  fprintf(stderr, "%d\n", X);
+  return 0;
+}
+
+extern "C" DLLEXPORT float print_float(float X) {
+  fprintf(stderr, "%f\n", X);
+  return 0;
+}
+
+extern "C" {
+    int reset_counts(int v);
+    int clear_counts();
+    float weighted(float x[20], int n);
+    int idot(int a[12], int n);
+    int count_flags(bool b);
+}
+
+int main() {
+    float x[20];
+    int a[12];
+    for (int i = 0; i < 20; i++) x[i] = i + 1;
+    for (int i = 0; i < 12; i++) a[i] = i + 1;
+
+    int r = reset_counts(3);     // 99 * 3 + 1
+    int z = clear_counts();
+    float w = weighted(x, 19);   // 0.5 * 190 + 190
+    int d = idot(a, 12);         // 1 + 4 + ... + 144
+    int neg = idot(a + 8, -3);   // a negative count sums nothing
+    int f = count_flags(true) + count_flags(false);
+
+    if (r == 298 && z == 0 && w == 285.0f && d == 650 && neg == 0 && f == 13)
+      std::cout << "PASSED Result: " << w << std::endl;
+    else
+      std::cout << "FAILED Result: " << r << " " << z << " " << w << " " << d << " " << neg << " " << f << std::endl;
+}
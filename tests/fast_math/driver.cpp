@@ -0,0 +1,49 @@
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+
+// clang++ driver.cpp output.ll -o fast_math
+
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+extern "C" DLLEXPORT int print_int(int X) {
+  fprintf(stderr, "%d\n", X);
+  return 0;
+}
+
+extern "C" DLLEXPORT float print_float(float X) {
+  fprintf(stderr, "%f\n", X);
+  return 0;
+}
+
+extern "C" {
+    float dotp(float x[1000], float y[1000], int n);
+    float mean(float x[1000], int n);
+}
+
+int main() {
+    float x[1000], y[1000];
+    for (int i = 0; i < 1000; i++) {
+      x[i] = (i % 10) * 0.5f;
+      y[i] = (i % 4) * 0.25f;
+    }
+
+    // Reassociated sums round differently, so compare with a tolerance
+    double expect_dot = 0, expect_mean = 0;
+    for (int i = 0; i < 999; i++) {
+      expect_dot += (double)x[i] * y[i];
+      expect_mean += x[i] / 999.0;
+    }
+    float d = dotp(x, y, 999);
+    float m = mean(x, 999);
+
+    if (std::fabs(d - expect_dot) < 1e-3 * expect_dot && std::fabs(m - expect_mean) < 1e-3 * expect_mean)
+      std::cout << "PASSED Result: " << d << " " << m << std::endl;
+    else
+      std::cout << "FAILED Result: " << d << " " << m << std::endl;
+}
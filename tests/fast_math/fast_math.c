@@ -0,0 +1,26 @@
+// MiniC program with float reductions that -ffast-math lets LLVM vectorize,
+// compiled by tests.sh with -ffast-math -O2
+
+float dotp(float x[1000], float y[1000], int n) {
+  int i;
+  float s;
+  s = 0.0;
+  i = 0;
+  while (i < n) {
+    s = s + x[i] * y[i];
+    i = i + 1;
+  }
+  return s;
+}
+
+float mean(float x[1000], int n) {
+  int i;
+  float s;
+  s = 0.0;
+  i = 0;
+  while (i < n) {
+    s = s + x[i] / n;
+    i = i + 1;
+  }
+  return s;
+}
@@ -0,0 +1,41 @@
+#include <iostream>
+#include <cstdio>
+
+// clang++ driver.cpp output.ll -o index_width
+
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+extern "C" DLLEXPORT int print_int(int X) {
+  fprintf(stderr, "%d\n", X);
+  return 0;
+}
+
+extern "C" DLLEXPORT float print_float(float X) {
+  fprintf(stderr, "%f\n", X);
+  return 0;
+}
+
+extern "C" {
+    float grid[40000];
+    float fill_grid(int rows, int cols);
+    float second_diff(float x[1000], int n);
+}
+
+int main() {
+    float x[1000];
+    for (int i = 0; i < 1000; i++) x[i] = i * i;
+
+    float last = fill_grid(200, 200);       // 199 - 3
+    float g = grid[150 * 200 + 7];        // 150 - 7
+    float d = second_diff(x, 1000);       // 2 * 998
+
+    if (last == 196.0f && g == 143.0f && d == 1996.0f)
+      std::cout << "PASSED Result: " << d << std::endl;
+    else
+      std::cout << "FAILED Result: " << last << " " << g << " " << d << std::endl;
+}
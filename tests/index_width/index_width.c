@@ -0,0 +1,31 @@
+// MiniC program whose array subscripts are arithmetic on int variables,
+// compiled by tests.sh with --index-width=64
+
+float grid[40000];
+
+float fill_grid(int rows, int cols) {
+  int i;
+  int j;
+  i = 0;
+  while (i < rows) {
+    j = 0;
+    while (j < cols) {
+      grid[i * cols + j] = i - j;
+      j = j + 1;
+    }
+    i = i + 1;
+  }
+  return grid[(rows - 1) * cols + 3];
+}
+
+float second_diff(float x[1000], int n) {
+  int i;
+  float s;
+  s = 0.0;
+  i = 1;
+  while (i < n - 1) {
+    s = s + x[i - 1] - 2 * x[i] + x[i + 1];
+    i = i + 1;
+  }
+  return s;
+}
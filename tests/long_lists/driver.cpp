@@ -0,0 +1,36 @@
+#include <iostream>
+#include <cstdio>
+
+// ./generate.sh > long_lists.c
+// (ulimit -s 1024; ../../mccomp ./long_lists.c)
+// clang++ driver.cpp output.ll -o long_lists
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+extern "C" DLLEXPORT int print_int(int X) {
+  fprintf(stderr, "%d\n", X);
+  return 0;
+}
+
+extern "C" DLLEXPORT float print_float(float X) {
+  fprintf(stderr, "%f\n", X);
+  return 0;
+}
+
+extern "C" {
+    int long_lists(int x);
+}
+
+int main() {
+    // x + (20000 increments) + wide(99, 0, ..., 0, 99) + x
+    int result = long_lists(5);
+
+    if (result == 20208)
+      std::cout << "PASSED Result: " << result << std::endl;
+    else
+      std::cout << "FAILED Result: " << result << std::endl;
+}
@@ -0,0 +1,35 @@
+#!/bin/bash
+# Generate long_lists.c: very long extern, top-level declaration, parameter,
+# local declaration and statement lists. tests.sh compiles it under a small
+# stack limit, so parsing must not recurse once per list element.
+#
+# Usage: ./generate.sh [N] > long_lists.c      (default N = 100000)
+N=${1:-100000}
+
+awk -v n="$N" 'BEGIN {
+    # With the recursive parser each of the extern, declaration, local and
+    # statement lists alone overflowed a 1MB stack at the default N
+    externs = n / 2; locals = n / 10; stmts = n / 5; params = 100
+
+    print "// Generated by tests/long_lists/generate.sh " n
+    for (i = 0; i < externs; i++) print "extern int ext" i "(int x);"
+    for (i = 0; i < n; i++) print "int g" i ";"
+
+    # wide(p0, ..., p99) = p0 + p99
+    printf "int wide(int p0"
+    for (i = 1; i < params; i++) printf ", int p%d", i
+    print ") {"
+    print "  return p0 + p" params - 1 ";"
+    print "}"
+
+    # long_lists(x) = x + stmts + 2 * (params - 1) + x
+    print "int long_lists(int x) {"
+    for (i = 0; i < locals; i++) print "  int v" i ";"
+    print "  v0 = x;"
+    for (i = 0; i < stmts; i++) print "  v0 = v0 + 1;"
+    printf "  v0 = v0 + wide(%d", params - 1
+    for (i = 1; i < params - 1; i++) printf ", 0"
+    printf ", %d);\n", params - 1
+    print "  return v0 + x;"
+    print "}"
+}'
@@ -239,7 +239,26 @@ int main() {
 }
 EOF
 
-echo "Generated 22 syntax error tests"
+# Test 23: Void parameter after other parameters
+cat > "$SYNTAX_DIR/void_param.c" << 'EOF'
+// INVALID - Syntax Error: only a lone "void" may stand for an empty parameter list
+// Expected: "expected 'int', 'bool', 'float', 'int4', 'float4' or 'float8' in parameter declaration"
+int f(int a, void b) {  // ERROR: parameter 'b' has void type
+    return a;
+}
+EOF
+
+# Test 24: Array alignment that is not a power of two
+cat > "$SYNTAX_DIR/array_align.c" << 'EOF'
+// INVALID - Syntax Error: aligned(N) takes a power of two
+// Expected: "array alignment must be a power of two up to 4096"
+int main() {
+    float buf[16] aligned(24);  // ERROR: 24 is not a power of two
+    return 0;
+}
+EOF
+
+echo "Generated 24 syntax error tests"
 
 # =================================================================
 # SEMANTIC TYPE ERROR TESTS (25+ files)
@@ -637,7 +656,59 @@ int main() {
 }
 EOF
 
-echo "Generated 27 semantic type error tests"
+# Type Test 28: Void call used as an operand
+cat > "$SEMANTIC_DIR/void_operand.c" << 'EOF'
+// INVALID - Type Error: a void call has no value
+// Expected: "invalid operand types"
+void reset() {
+    return;
+}
+
+int main() {
+    int x;
+    x = 1 + reset();  // ERROR: reset() yields no value
+    return x;
+}
+EOF
+
+# Type Test 29: Comparison between vectors
+cat > "$SEMANTIC_DIR/vector_compare.c" << 'EOF'
+// INVALID - Type Error: vectors support lane-wise arithmetic only
+// Expected: "invalid operand types"
+int main() {
+    float4 a;
+    float4 b;
+    a = 1.0;
+    b = a * 2.0;
+    if (a < b) {  // ERROR: no ordering on float4
+        return 1;
+    }
+    return 0;
+}
+EOF
+
+# Type Test 30: fill on an array parameter
+cat > "$SEMANTIC_DIR/fill_unsized.c" << 'EOF'
+// INVALID - Type Error: fill needs the size of an array declaration
+// Expected: "requires an array of known size"
+int reset(int a[10]) {
+    fill(a, 0);  // ERROR: a is an int* parameter
+    return 0;
+}
+EOF
+
+# Type Test 31: Negative constant vector lane
+cat > "$SEMANTIC_DIR/vector_negative_lane.c" << 'EOF'
+// INVALID - Type Error: a constant lane must lie within the vector
+// Expected: "Vector lane -1 out of range"
+int main() {
+    int4 v;
+    v = 0;
+    return v[-1];  // ERROR: int4 has lanes 0 to 3
+}
+EOF
+
+echo "Generated 31 semantic type error tests"
 
 # =================================================================
 # SEMANTIC SCOPE ERROR TESTS (15+ files)
@@ -929,9 +1000,9 @@ EOF
 echo "Generated 3 valid reference tests"
 echo ""
 echo "Test generation complete!"
-echo "Total syntax error tests: 22"
-echo "Total semantic type error tests: 27"
+echo "Total syntax error tests: 24"
+echo "Total semantic type error tests: 31"
 echo "Total scope error tests: 17"
 echo "Total valid reference tests: 6"
-echo "Grand total: 72 test files"
+echo "Grand total: 78 test files"
 
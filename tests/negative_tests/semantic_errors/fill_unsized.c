@@ -0,0 +1,6 @@
+// INVALID - Type Error: fill needs the size of an array declaration
+// Expected: "requires an array of known size"
+int reset(int a[10]) {
+    fill(a, 0);  // ERROR: a is an int* parameter
+    return 0;
+}
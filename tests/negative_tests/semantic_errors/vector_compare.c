@@ -0,0 +1,12 @@
+// INVALID - Type Error: vectors support lane-wise arithmetic only
+// Expected: "invalid operand types"
+int main() {
+    float4 a;
+    float4 b;
+    a = 1.0;
+    b = a * 2.0;
+    if (a < b) {  // ERROR: no ordering on float4
+        return 1;
+    }
+    return 0;
+}
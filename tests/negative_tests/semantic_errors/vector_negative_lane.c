@@ -0,0 +1,7 @@
+// INVALID - Type Error: a constant lane must lie within the vector
+// Expected: "Vector lane -1 out of range"
+int main() {
+    int4 v;
+    v = 0;
+    return v[-1];  // ERROR: int4 has lanes 0 to 3
+}
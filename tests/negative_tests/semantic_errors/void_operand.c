@@ -0,0 +1,11 @@
+// INVALID - Type Error: a void call has no value
+// Expected: "invalid operand types"
+void reset() {
+    return;
+}
+
+int main() {
+    int x;
+    x = 1 + reset();  // ERROR: reset() yields no value
+    return x;
+}
@@ -0,0 +1,6 @@
+// INVALID - Syntax Error: aligned(N) takes a power of two
+// Expected: "array alignment must be a power of two up to 4096"
+int main() {
+    float buf[16] aligned(24);  // ERROR: 24 is not a power of two
+    return 0;
+}
@@ -0,0 +1,5 @@
+// INVALID - Syntax Error: only a lone "void" may stand for an empty parameter list
+// Expected: "expected 'int', 'bool', 'float', 'int4', 'float4' or 'float8' in parameter declaration"
+int f(int a, void b) {  // ERROR: parameter 'b' has void type
+    return a;
+}
@@ -0,0 +1,582 @@
+// runner - run every mccomp test suite in parallel, with result caching.
+//
+// Usage (from the repository root, after `make mccomp`):
+//   tests/runner [-j N] [--timeout SECS] [--no-cache] [--cache FILE] [--bench] [FILTER]
+//
+// Suites:
+//   runtime/*        tests/<case>/: compile with mccomp, link driver.cpp, expect "PASSED"
+//                    (cases without a driver only have to compile; cases with a
+//                    generate.sh compile its output under a 1MB stack limit; a
+//                    flags file holds extra mccomp options, as tests.sh passes them)
+//   comprehensive/*  comprehensive_tests/*_tests: compile or reject, as run_all_tests.sh
+//   negative/*       tests/negative_tests/*: reject with the expected error kind
+//                    (PARTIAL = rejected, but with a different error)
+//
+// A case whose source, driver, expectation and mccomp binary are unchanged
+// since it last passed is not re-run; its cached duration is reported instead.
+// Benchmarks (--bench) always run, one at a time, after the tests.
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+// Bump when the way cases are judged changes, to invalidate old cache entries
+static const char* RunnerVersion = "runner-2";
+
+enum class Expect { Run, Compile, Reject };
+enum class Status { Pass, Partial, Fail, Cached };
+
+struct TestCase {
+    std::string Id;            // suite/name
+    fs::path Source;           // the MiniC file, or the generate.sh producing it
+    bool Generated = false;    // Source is a generator script
+    fs::path Driver;           // driver.cpp for Expect::Run
+    std::vector<std::string> Flags;  // extra mccomp options (runtime cases' flags file)
+    Expect Kind = Expect::Compile;
+    std::string ErrorPattern;  // Expect::Reject: '|'-separated, case-insensitive
+};
+
+struct TestResult {
+    Status S = Status::Fail;
+    double Seconds = 0;
+    std::string Detail;
+};
+
+struct ProcessResult {
+    int ExitCode = -1;     // exit status, or -1 if killed by a signal/timeout
+    bool TimedOut = false;
+    int Signal = 0;
+    std::string Output;    // stdout and stderr interleaved
+};
+
+static fs::path Root;
+static fs::path Compiler;
+static std::string Clang = "clang++";
+static unsigned TimeoutSecs = 5;
+static bool UseColor = false;
+static std::mutex OutputLock;
+
+//===----------------------------------------------------------------------===//
+// Helpers
+//===----------------------------------------------------------------------===//
+
+static const char* color(const char* Code) { return UseColor ? Code : ""; }
+
+static std::string readFile(const fs::path& Path) {
+    std::ifstream In(Path, std::ios::binary);
+    std::ostringstream SS;
+    SS << In.rdbuf();
+    return SS.str();
+}
+
+static std::string toLower(std::string S) {
+    for (char& C : S) C = (char)tolower((unsigned char)C);
+    return S;
+}
+
+// FNV-1a, 64 bit - only used for change detection, not security
+static uint64_t hashBytes(const std::string& Data, uint64_t H = 1469598103934665603ULL) {
+    for (unsigned char C : Data) {
+        H ^= C;
+        H *= 1099511628211ULL;
+    }
+    return H;
+}
+
+static std::string hex(uint64_t V) {
+    char Buf[17];
+    snprintf(Buf, sizeof(Buf), "%016llx", (unsigned long long)V);
+    return Buf;
+}
+
+// runProcess - run Argv in Dir, capturing its output; kill it after Timeout seconds
+static ProcessResult runProcess(const std::vector<std::string>& Argv, const fs::path& Dir,
+                                unsigned Timeout, rlim_t StackLimit = RLIM_INFINITY) {
+    ProcessResult R;
+    int Pipe[2];
+    if (pipe(Pipe) != 0) {
+        R.Output = std::string("pipe: ") + strerror(errno);
+        return R;
+    }
+
+    pid_t Pid = fork();
+    if (Pid < 0) {
+        R.Output = std::string("fork: ") + strerror(errno);
+        close(Pipe[0]);
+        close(Pipe[1]);
+        return R;
+    }
+    if (Pid == 0) {
+        if (chdir(Dir.c_str()) != 0) _exit(126);
+        if (StackLimit != RLIM_INFINITY) {
+            struct rlimit Limit = {StackLimit, StackLimit};
+            setrlimit(RLIMIT_STACK, &Limit);
+        }
+        dup2(Pipe[1], STDOUT_FILENO);
+        dup2(Pipe[1], STDERR_FILENO);
+        close(Pipe[0]);
+        close(Pipe[1]);
+        std::vector<char*> Args;
+        for (const std::string& A : Argv) Args.push_back(const_cast<char*>(A.c_str()));
+        Args.push_back(nullptr);
+        execvp(Args[0], Args.data());
+        fprintf(stderr, "cannot run %s: %s\n", Args[0], strerror(errno));
+        _exit(127);
+    }
+    close(Pipe[1]);
+
+    Clock::time_point Deadline = Clock::now() + std::chrono::seconds(Timeout);
+    char Buf[4096];
+    for (;;) {
+        int Left = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+                       Deadline - Clock::now()).count();
+        if (Left <= 0) {
+            R.TimedOut = true;
+            kill(Pid, SIGKILL);
+            break;
+        }
+        struct pollfd P = {Pipe[0], POLLIN, 0};
+        if (poll(&P, 1, Left) <= 0) continue;
+        ssize_t N = read(Pipe[0], Buf, sizeof(Buf));
+        if (N <= 0) break;  // EOF: the child closed its output
+        R.Output.append(Buf, (size_t)N);
+    }
+    close(Pipe[0]);
+
+    // The child may close its output and keep running, so the wait shares the deadline
+    int WStatus = 0;
+    while (!R.TimedOut && waitpid(Pid, &WStatus, WNOHANG) == 0) {
+        if (Clock::now() >= Deadline) {
+            R.TimedOut = true;
+            kill(Pid, SIGKILL);
+            break;
+        }
+        usleep(1000);
+    }
+    if (R.TimedOut) {
+        waitpid(Pid, &WStatus, 0);
+        return R;
+    }
+    if (WIFEXITED(WStatus))
+        R.ExitCode = WEXITSTATUS(WStatus);
+    else if (WIFSIGNALED(WStatus))
+        R.Signal = WTERMSIG(WStatus);
+    return R;
+}
+
+static std::string stripColors(const std::string& S) {
+    std::string Out;
+    for (size_t I = 0; I < S.size(); I++) {
+        if (S[I] == '\033' && I + 1 < S.size() && S[I + 1] == '[') {
+            while (I < S.size() && !isalpha((unsigned char)S[I])) I++;
+            continue;
+        }
+        Out += S[I];
+    }
+    return Out;
+}
+
+// firstErrorLine - the first diagnostic mentioning "error", for failure details
+static std::string firstErrorLine(const std::string& Output) {
+    std::istringstream In(stripColors(Output));
+    std::string Line;
+    while (std::getline(In, Line)) {
+        std::string Lower = toLower(Line);
+        // Skip the "Compilation Failed - N Error(s) Found" banner
+        if (Lower.find("error") != std::string::npos && Lower.find("error(s)") == std::string::npos)
+            return Line;
+    }
+    return "";
+}
+
+static std::string describeFailure(const ProcessResult& P, const char* What) {
+    if (P.TimedOut) return std::string(What) + " timed out";
+    if (P.Signal) return std::string(What) + " killed by signal " + std::to_string(P.Signal);
+    std::string Msg = std::string(What) + " exited with " + std::to_string(P.ExitCode);
+    std::string Err = firstErrorLine(P.Output);
+    return Err.empty() ? Msg : Msg + ": " + Err;
+}
+
+//===----------------------------------------------------------------------===//
+// Test discovery
+//===----------------------------------------------------------------------===//
+
+static std::vector<fs::path> sourcesIn(const fs::path& Dir) {
+    std::vector<fs::path> Files;
+    if (!fs::is_directory(Dir)) return Files;
+    for (const fs::directory_entry& E : fs::directory_iterator(Dir))
+        if (E.is_regular_file() && E.path().extension() == ".c") Files.push_back(E.path());
+    std::sort(Files.begin(), Files.end());
+    return Files;
+}
+
+static void addRuntimeCases(std::vector<TestCase>& Cases) {
+    std::vector<fs::path> Dirs;
+    for (const fs::directory_entry& E : fs::directory_iterator(Root / "tests"))
+        if (E.is_directory() && E.path().filename() != "negative_tests") Dirs.push_back(E.path());
+    std::sort(Dirs.begin(), Dirs.end());
+
+    for (const fs::path& Dir : Dirs) {
+        std::vector<fs::path> Sources = sourcesIn(Dir);
+        TestCase T;
+        T.Id = "runtime/" + Dir.filename().string();
+        if (fs::exists(Dir / "generate.sh")) {
+            T.Source = Dir / "generate.sh";
+            T.Generated = true;
+        } else if (Sources.size() == 1) {
+            T.Source = Sources[0];
+        } else {
+            continue;
+        }
+        if (fs::exists(Dir / "driver.cpp")) {
+            T.Kind = Expect::Run;
+            T.Driver = Dir / "driver.cpp";
+        }
+        std::istringstream Flags(readFile(Dir / "flags"));
+        for (std::string Flag; Flags >> Flag;) T.Flags.push_back(Flag);
+        Cases.push_back(T);
+    }
+}
+
+static void addComprehensiveCases(std::vector<TestCase>& Cases) {
+    static const char* Suites[] = {"type_tests", "scope_tests", "func_tests",
+                                   "expr_tests", "ctrl_tests", "error_tests"};
+    for (const char* Suite : Suites) {
+        std::string Name = Suite;
+        for (const fs::path& Src : sourcesIn(Root / "comprehensive_tests" / Suite)) {
+            std::string File = Src.filename().string();
+            TestCase T;
+            T.Id = "comprehensive/" + Name + "/" + Src.stem().string();
+            T.Source = Src;
+            // Same expectations as comprehensive_tests/run_all_tests.sh
+            bool Reject;
+            if (Name == "expr_tests" || Name == "ctrl_tests")
+                Reject = false;
+            else if (Name == "error_tests")
+                Reject = File != "10_missing_return.c";
+            else
+                Reject = File.find("error") != std::string::npos;
+            T.Kind = Reject ? Expect::Reject : Expect::Compile;
+            Cases.push_back(T);
+        }
+    }
+}
+
+static void addNegativeCases(std::vector<TestCase>& Cases) {
+    // Error kinds as in tests/test_negative.sh
+    static const std::pair<const char*, const char*> Suites[] = {
+        {"syntax_errors", "syntax error"},
+        {"semantic_errors", "type error|semantic error"},
+        {"scope_errors", "scope error|undefined|redeclaration"},
+        {"reference_valid", nullptr},
+    };
+    for (const auto& Suite : Suites) {
+        for (const fs::path& Src : sourcesIn(Root / "tests" / "negative_tests" / Suite.first)) {
+            TestCase T;
+            T.Id = std::string("negative/") + Suite.first + "/" + Src.stem().string();
+            T.Source = Src;
+            T.Kind = Suite.second ? Expect::Reject : Expect::Compile;
+            if (Suite.second) T.ErrorPattern = Suite.second;
+            Cases.push_back(T);
+        }
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Running and caching
+//===----------------------------------------------------------------------===//
+
+static std::string cacheKey(const TestCase& T, uint64_t CompilerHash) {
+    uint64_t H = hashBytes(RunnerVersion);
+    H = hashBytes(hex(CompilerHash), H);
+    H = hashBytes(std::to_string((int)T.Kind) + "\n" + T.ErrorPattern + "\n", H);
+    H = hashBytes(readFile(T.Source), H);
+    for (const std::string& Flag : T.Flags) H = hashBytes(Flag + "\n", H);
+    if (T.Kind == Expect::Run) {
+        H = hashBytes(Clang, H);
+        H = hashBytes(readFile(T.Driver), H);
+    }
+    return hex(H);
+}
+
+static bool matchesErrorPattern(const std::string& Output, const std::string& Pattern) {
+    std::string Lower = toLower(Output);
+    std::istringstream Alternatives(Pattern);
+    std::string Alt;
+    while (std::getline(Alternatives, Alt, '|'))
+        if (Lower.find(Alt) != std::string::npos) return true;
+    return false;
+}
+
+static TestResult runCase(const TestCase& T) {
+    TestResult R;
+    Clock::time_point Start = Clock::now();
+
+    char Template[] = "/tmp/mccomp-test-XXXXXX";
+    if (!mkdtemp(Template)) {
+        R.Detail = std::string("mkdtemp: ") + strerror(errno);
+        return R;
+    }
+    fs::path Work = Template;
+
+    // Generated inputs are large: allow them more time, but only 1MB of stack
+    fs::path Source = fs::absolute(T.Source);
+    unsigned Timeout = TimeoutSecs;
+    rlim_t StackLimit = RLIM_INFINITY;
+    if (T.Generated) {
+        ProcessResult Gen = runProcess({"bash", Source.string()}, Work, 60);
+        if (Gen.ExitCode != 0) {
+            R.Detail = describeFailure(Gen, "generate.sh");
+            std::error_code EC;
+            fs::remove_all(Work, EC);
+            return R;
+        }
+        Source = Work / (T.Source.parent_path().filename().string() + ".c");
+        std::ofstream(Source) << Gen.Output;
+        Timeout *= 12;
+        StackLimit = 1024 * 1024;
+    }
+
+    std::vector<std::string> CompileArgs = {Compiler.string(), Source.string()};
+    CompileArgs.insert(CompileArgs.end(), T.Flags.begin(), T.Flags.end());
+    CompileArgs.insert(CompileArgs.end(), {"-o", (Work / "output.ll").string()});
+    ProcessResult Compile = runProcess(CompileArgs, Work, Timeout, StackLimit);
+    bool Compiled = Compile.ExitCode == 0;
+
+    switch (T.Kind) {
+    case Expect::Compile:
+        R.S = Compiled ? Status::Pass : Status::Fail;
+        if (!Compiled) R.Detail = describeFailure(Compile, "mccomp");
+        break;
+
+    case Expect::Reject:
+        // A crash or hang is never a correct rejection
+        if (Compiled) {
+            R.Detail = "accepted invalid code";
+        } else if (Compile.ExitCode < 0) {
+            R.Detail = describeFailure(Compile, "mccomp");
+        } else if (!T.ErrorPattern.empty() && !matchesErrorPattern(Compile.Output, T.ErrorPattern)) {
+            R.S = Status::Partial;
+            R.Detail = "expected '" + T.ErrorPattern + "', got: " + firstErrorLine(Compile.Output);
+        } else {
+            R.S = Status::Pass;
+        }
+        break;
+
+    case Expect::Run: {
+        if (!Compiled) {
+            R.Detail = describeFailure(Compile, "mccomp");
+            break;
+        }
+        ProcessResult Link = runProcess({Clang, fs::absolute(T.Driver).string(), "output.ll",
+                                         "-o", "test_exe"}, Work, 120);
+        if (Link.ExitCode != 0) {
+            R.Detail = describeFailure(Link, Clang.c_str());
+            break;
+        }
+        ProcessResult Exe = runProcess({(Work / "test_exe").string()}, Work, TimeoutSecs);
+        if (Exe.ExitCode != 0)
+            R.Detail = describeFailure(Exe, "test driver");
+        else if (Exe.Output.find("PASSED") == std::string::npos)
+            R.Detail = "driver did not report PASSED";
+        else
+            R.S = Status::Pass;
+        break;
+    }
+    }
+
+    std::error_code EC;
+    fs::remove_all(Work, EC);
+    R.Seconds = std::chrono::duration<double>(Clock::now() - Start).count();
+    return R;
+}
+
+struct CacheEntry {
+    std::string Key;
+    double Seconds;
+};
+
+static std::map<std::string, CacheEntry> loadCache(const fs::path& Path) {
+    std::map<std::string, CacheEntry> Cache;
+    std::ifstream In(Path);
+    std::string Id, Key;
+    double Seconds;
+    while (In >> Id >> Key >> Seconds) Cache[Id] = {Key, Seconds};
+    return Cache;
+}
+
+static void saveCache(const fs::path& Path, const std::map<std::string, CacheEntry>& Cache) {
+    fs::path Tmp = Path.string() + ".tmp";
+    {
+        std::ofstream Out(Tmp);
+        for (const auto& KV : Cache)
+            Out << KV.first << ' ' << KV.second.Key << ' ' << KV.second.Seconds << '\n';
+    }
+    std::error_code EC;
+    fs::rename(Tmp, Path, EC);
+}
+
+static void printResult(const TestCase& T, const TestResult& R) {
+    static const char* Labels[] = {"PASS", "PARTIAL", "FAIL", "CACHED"};
+    static const char* Colors[] = {"\033[0;32m", "\033[1;33m", "\033[0;31m", "\033[0;36m"};
+    std::lock_guard<std::mutex> Lock(OutputLock);
+    printf("%s[%-7s]%s %7.3fs  %s", color(Colors[(int)R.S]), Labels[(int)R.S], color("\033[0m"),
+           R.Seconds, T.Id.c_str());
+    if (!R.Detail.empty()) printf("  - %s", R.Detail.c_str());
+    printf("\n");
+    fflush(stdout);
+}
+
+static int runBenchmarks() {
+    static const char* Benchmarks[] = {"bench/compile_scaling.sh", "bench/parse_throughput.sh",
+                                         "bench/runtime_vs_clang.sh"};
+    int Failed = 0;
+    for (const char* Bench : Benchmarks) {
+        printf("\n==> %s\n", Bench);
+        fflush(stdout);
+        Clock::time_point Start = Clock::now();
+        int RC = system((Root / Bench).string().c_str());
+        double Secs = std::chrono::duration<double>(Clock::now() - Start).count();
+        printf("<== %s %s (%.1fs)\n", Bench, RC == 0 ? "done" : "FAILED", Secs);
+        if (RC != 0) Failed++;
+    }
+    return Failed;
+}
+
+static void printUsage(const char* Argv0) {
+    printf("Usage: %s [-j N] [--timeout SECS] [--no-cache] [--cache FILE] [--bench] [FILTER]\n",
+           Argv0);
+    printf("  -j N            run N cases at once (default: number of cores)\n");
+    printf("  --timeout SECS  per-process limit for mccomp and the test drivers (default 5)\n");
+    printf("  --no-cache      re-run cases even if their inputs are unchanged\n");
+    printf("  --cache FILE    cache location (default tests/.runner-cache)\n");
+    printf("  --bench         also run the benchmarks in bench/ (serially, never cached)\n");
+    printf("  FILTER          only run cases whose id contains FILTER\n");
+}
+
+int main(int argc, char** argv) {
+    unsigned Jobs = std::max(1u, std::thread::hardware_concurrency());
+    bool UseCache = true, Bench = false;
+    std::string Filter, CacheFile;
+
+    for (int I = 1; I < argc; I++) {
+        std::string Arg = argv[I];
+        if (Arg == "-j" && I + 1 < argc)
+            Jobs = std::max(1, atoi(argv[++I]));
+        else if (Arg.rfind("-j", 0) == 0 && Arg.size() > 2)
+            Jobs = std::max(1, atoi(Arg.c_str() + 2));
+        else if (Arg == "--timeout" && I + 1 < argc)
+            TimeoutSecs = std::max(1, atoi(argv[++I]));
+        else if (Arg == "--no-cache")
+            UseCache = false;
+        else if (Arg == "--cache" && I + 1 < argc)
+            CacheFile = argv[++I];
+        else if (Arg == "--bench")
+            Bench = true;
+        else if (Arg == "-h" || Arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (!Arg.empty() && Arg[0] != '-')
+            Filter = Arg;
+        else {
+            fprintf(stderr, "Unknown option: %s\n", Arg.c_str());
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    Root = fs::current_path();
+    Compiler = Root / "mccomp";
+    if (!fs::exists(Root / "mccomp.cpp") || !fs::exists(Compiler)) {
+        fprintf(stderr, "Run from the repository root after building mccomp (make mccomp)\n");
+        return 1;
+    }
+    if (const char* Env = getenv("CLANG")) Clang = Env;
+    UseColor = isatty(STDOUT_FILENO);
+    if (CacheFile.empty()) CacheFile = (Root / "tests" / ".runner-cache").string();
+
+    std::vector<TestCase> All, Cases;
+    addRuntimeCases(All);
+    addComprehensiveCases(All);
+    addNegativeCases(All);
+    for (const TestCase& T : All)
+        if (Filter.empty() || T.Id.find(Filter) != std::string::npos) Cases.push_back(T);
+
+    uint64_t CompilerHash = hashBytes(readFile(Compiler));
+    std::map<std::string, CacheEntry> Cache;
+    if (UseCache) Cache = loadCache(CacheFile);
+
+    std::vector<std::string> Keys(Cases.size());
+    std::vector<TestResult> Results(Cases.size());
+    for (size_t I = 0; I < Cases.size(); I++) Keys[I] = cacheKey(Cases[I], CompilerHash);
+
+    printf("Running %zu case(s) on %u thread(s)\n", Cases.size(), Jobs);
+    Clock::time_point Start = Clock::now();
+
+    std::atomic<size_t> Next(0);
+    auto Worker = [&]() {
+        for (size_t I = Next++; I < Cases.size(); I = Next++) {
+            auto Hit = Cache.find(Cases[I].Id);
+            if (UseCache && Hit != Cache.end() && Hit->second.Key == Keys[I]) {
+                Results[I].S = Status::Cached;
+                Results[I].Seconds = Hit->second.Seconds;
+            } else {
+                Results[I] = runCase(Cases[I]);
+            }
+            printResult(Cases[I], Results[I]);
+        }
+    };
+    std::vector<std::thread> Pool;
+    for (unsigned T = 1; T < std::min<size_t>(Jobs, Cases.size()); T++) Pool.emplace_back(Worker);
+    Worker();
+    for (std::thread& T : Pool) T.join();
+
+    double Wall = std::chrono::duration<double>(Clock::now() - Start).count();
+
+    // Only passing results are cached; failures always re-run
+    unsigned Counts[4] = {0, 0, 0, 0};
+    for (size_t I = 0; I < Cases.size(); I++) {
+        Counts[(int)Results[I].S]++;
+        if (Results[I].S == Status::Pass)
+            Cache[Cases[I].Id] = {Keys[I], Results[I].Seconds};
+        else if (Results[I].S != Status::Cached)
+            Cache.erase(Cases[I].Id);
+    }
+    if (UseCache) saveCache(CacheFile, Cache);
+
+    std::vector<size_t> Order(Cases.size());
+    for (size_t I = 0; I < Order.size(); I++) Order[I] = I;
+    std::sort(Order.begin(), Order.end(),
+              [&](size_t A, size_t B) { return Results[A].Seconds > Results[B].Seconds; });
+    printf("\nSlowest cases:\n");
+    for (size_t I = 0; I < std::min<size_t>(5, Order.size()); I++)
+        printf("  %7.3fs  %s%s\n", Results[Order[I]].Seconds, Cases[Order[I]].Id.c_str(),
+               Results[Order[I]].S == Status::Cached ? " (cached)" : "");
+
+    printf("\n%zu case(s) in %.2fs: %u passed, %u cached, %u partial, %u failed\n", Cases.size(),
+           Wall, Counts[(int)Status::Pass], Counts[(int)Status::Cached],
+           Counts[(int)Status::Partial], Counts[(int)Status::Fail]);
+
+    int BenchFailures = Bench ? runBenchmarks() : 0;
+    return Counts[(int)Status::Fail] || BenchFailures ? 1 : 0;
+}
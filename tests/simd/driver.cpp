@@ -0,0 +1,44 @@
+#include <iostream>
+#include <cstdio>
+
+// clang++ driver.cpp output.ll -o simd
+
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+extern "C" DLLEXPORT int print_int(int X) {
+  fprintf(stderr, "%d\n", X);
+  return 0;
+}
+
+extern "C" DLLEXPORT float print_float(float X) {
+  fprintf(stderr, "%f\n", X);
+  return 0;
+}
+
+extern "C" {
+    float scaled(float s);
+    float dot8(float a[8], float b[8]);
+    int imix(int n);
+    float wide(float x);
+}
+
+int main() {
+    // vectors stay inside the MiniC code, so only scalars and arrays cross the ABI
+    float a[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    float b[8] = {8, 7, 6, 5, 4, 3, 2, 1};
+
+    float s = scaled(2.0f);  // (1 + 1 + 3 + 1) * 2 + 4 * 0.5
+    float d = dot8(a, b);
+    int m = imix(5);         // (12 + 10 + 11 + 12) + 8 - 5
+    float w = wide(0.5f);    // 32 + 100 - 6.5 + 3.5
+
+    if (s == 14.0f && d == 120.0f && m == 48 && w == 129.0f)
+      std::cout << "PASSED Result: " << d << std::endl;
+    else
+      std::cout << "FAILED Result: " << s << " " << d << " " << m << " " << w << std::endl;
+}
@@ -0,0 +1,64 @@
+// MiniC program using the SIMD vector types: splats, lane access,
+// lane-wise arithmetic and horizontal reductions
+
+float4 bias;
+
+float4 scale(float4 v, float s) {
+  return v * s;
+}
+
+float scaled(float s) {
+  float4 v;
+  v = 1.0;
+  v[2] = 3.0;
+  bias = 0.5;
+  return hsum(scale(v, s) + bias);
+}
+
+// dot product of two 8-element arrays, four lanes at a time
+float dot8(float a[8], float b[8]) {
+  float4 acc;
+  float4 x;
+  float4 y;
+  int i;
+  int j;
+  acc = 0.0;
+  i = 0;
+  while (i < 8) {
+    j = 0;
+    while (j < 4) {
+      x[j] = a[i + j];
+      y[j] = b[i + j];
+      j = j + 1;
+    }
+    acc = acc + x * y;
+    i = i + 4;
+  }
+  return hsum(acc);
+}
+
+int imix(int n) {
+  int4 v;
+  int4 w;
+  v[0] = n;
+  v[1] = n + 1;
+  v[2] = n + 2;
+  v[3] = n + 3;
+  w = v % 3 + 10;
+  return hsum(w) + hmax(v) - hmin(v);
+}
+
+float wide(float x) {
+  float8 v;
+  float8 rows[2];
+  int i;
+  i = 0;
+  while (i < 8) {
+    v[i] = i;
+    i = i + 1;
+  }
+  rows[0] = v + x;
+  rows[1] = -rows[0];
+  rows[1][7] = 100.0;
+  return hsum(rows[0]) + hmax(rows[1]) + hmin(rows[1]) + rows[0][3];
+}
@@ -0,0 +1,40 @@
+#include <iostream>
+#include <cstdio>
+
+// clang++ driver.cpp output.ll -o static_linkage
+
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+extern "C" DLLEXPORT int print_int(int X) {
+  fprintf(stderr, "%d\n", X);
+  return 0;
+}
+
+extern "C" DLLEXPORT float print_float(float X) {
+  fprintf(stderr, "%f\n", X);
+  return 0;
+}
+
+extern "C" {
+    int sum_of_squares(int n);
+}
+
+// The MiniC square, calls and scale are static: a second external square would not
+// link, and calls and scale would otherwise be merged with these and updated
+extern "C" int square(int x) { return -x; }
+extern "C" int calls = 0;
+extern "C" int scale[4] = {0, 0, 0, 0};
+
+int main() {
+    int result = sum_of_squares(10);
+
+    if (result == 385 && square(2) == -2 && calls == 0 && scale[0] == 0)
+      std::cout << "PASSED Result: " << result << std::endl;
+    else
+      std::cout << "FAILED Result: " << result << " " << calls << " " << scale[0] << std::endl;
+}
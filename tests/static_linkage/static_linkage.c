@@ -0,0 +1,28 @@
+// MiniC program with module-private helpers and state
+
+static int calls;
+static int scale[4];
+
+static int square(int x);
+
+int sum_of_squares(int n) {
+  int i;
+  int s;
+  s = 0;
+  i = 1;
+  while (i <= n) {
+    s = s + square(i);
+    i = i + 1;
+  }
+  scale[0] = s;
+  return scale[0];
+}
+
+static int square(int x) {
+  calls = calls + 1;
+  return x * x;
+}
+
+static int unused(int x) {
+  return x + calls;
+}
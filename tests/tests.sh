@@ -68,8 +68,18 @@ leap=1
 # array tests -- set to 1 after completing Part 3 - Grand Finale
 array_addition=1
 array_func_arg_1d=1
+array_func_arg_3d=1
 matrix_mul=1
 global_array=1
+static_linkage=1
+simd=1
+bulk_arrays=1
+zero_init=1
+array_align=1
+index_width=1
+wrapv=1
+fast_math=1
+long_lists=1
 
 
 cd tests/addition/
@@ -259,6 +269,18 @@ then
     fi
 fi
 
+if [ $array_func_arg_3d == 1 ];
+then
+    cd ../array_func_arg_3d
+    pwd
+    rm -rf output.ll array_func_arg_3d
+    "$COMP" ./arr_func_arg_3d.c
+    if [ $TEST_COMPILE_ONLY == 0 ]; then
+        $CLANG -g driver.cpp output.ll -o array_func_arg_3d
+        validate "./array_func_arg_3d"
+    fi
+fi
+
 if [ $matrix_mul == 1 ];
 then	
     cd ../matrix_multiplication
@@ -282,4 +304,114 @@ then
     fi
 fi
 
+if [ $static_linkage == 1 ];
+then
+    cd ../static_linkage
+    pwd
+    rm -rf output.ll static_linkage
+    "$COMP" ./static_linkage.c
+    if [ $TEST_COMPILE_ONLY == 0 ]; then
+        $CLANG -g driver.cpp output.ll -o static_linkage
+        validate "./static_linkage"
+    fi
+fi
+
+if [ $simd == 1 ];
+then
+    cd ../simd
+    pwd
+    rm -rf output.ll simd
+    "$COMP" ./simd.c
+    if [ $TEST_COMPILE_ONLY == 0 ]; then
+        $CLANG -g driver.cpp output.ll -o simd
+        validate "./simd"
+    fi
+fi
+
+if [ $bulk_arrays == 1 ];
+then
+    cd ../bulk_arrays
+    pwd
+    rm -rf output.ll bulk_arrays
+    "$COMP" ./bulk_arrays.c
+    if [ $TEST_COMPILE_ONLY == 0 ]; then
+        $CLANG -g driver.cpp output.ll -o bulk_arrays
+        validate "./bulk_arrays"
+    fi
+fi
+
+if [ $zero_init == 1 ];
+then
+    cd ../zero_init
+    pwd
+    rm -rf output.ll zero_init
+    "$COMP" ./zero_init.c
+    if [ $TEST_COMPILE_ONLY == 0 ]; then
+        $CLANG -g driver.cpp output.ll -o zero_init
+        validate "./zero_init"
+    fi
+fi
+
+if [ $array_align == 1 ];
+then
+    cd ../array_align
+    pwd
+    rm -rf output.ll array_align
+    "$COMP" ./array_align.c
+    if [ $TEST_COMPILE_ONLY == 0 ]; then
+        $CLANG -g driver.cpp output.ll -o array_align
+        validate "./array_align"
+    fi
+fi
+
+if [ $index_width == 1 ];
+then
+    cd ../index_width
+    pwd
+    rm -rf output.ll index_width
+    "$COMP" $(cat flags) ./index_width.c
+    if [ $TEST_COMPILE_ONLY == 0 ]; then
+        $CLANG -g driver.cpp output.ll -o index_width
+        validate "./index_width"
+    fi
+fi
+
+if [ $wrapv == 1 ];
+then
+    cd ../wrapv
+    pwd
+    rm -rf output.ll wrapv
+    "$COMP" $(cat flags) ./wrapv.c
+    if [ $TEST_COMPILE_ONLY == 0 ]; then
+        $CLANG -g driver.cpp output.ll -o wrapv
+        validate "./wrapv"
+    fi
+fi
+
+if [ $fast_math == 1 ];
+then
+    cd ../fast_math
+    pwd
+    rm -rf output.ll fast_math
+    "$COMP" $(cat flags) ./fast_math.c
+    if [ $TEST_COMPILE_ONLY == 0 ]; then
+        $CLANG -g driver.cpp output.ll -o fast_math
+        validate "./fast_math"
+    fi
+fi
+
+if [ $long_lists == 1 ];
+then
+    cd ../long_lists
+    pwd
+    rm -rf output.ll long_lists long_lists.c
+    ./generate.sh > long_lists.c
+    # 1MB of stack: parsing must not recurse once per list element
+    (ulimit -s 1024; "$COMP" ./long_lists.c > /dev/null 2>&1)
+    if [ $TEST_COMPILE_ONLY == 0 ]; then
+        $CLANG -g driver.cpp output.ll -o long_lists
+        validate "./long_lists"
+    fi
+fi
+
 echo "***** ALL TESTS PASSED *****"
@@ -0,0 +1,43 @@
+#include <iostream>
+#include <cstdio>
+#include <climits>
+
+// clang++ driver.cpp output.ll -o wrapv
+
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+extern "C" DLLEXPORT int print_int(int X) {
+  fprintf(stderr, "%d\n", X);
+  return 0;
+}
+
+extern "C" DLLEXPORT float print_float(float X) {
+  fprintf(stderr, "%f\n", X);
+  return 0;
+}
+
+extern "C" {
+    bool still_larger(int i);
+    int hash(int n);
+    int wrapped_index(int i, int cols, int j);
+}
+
+int main() {
+    unsigned expected = 7;
+    for (unsigned i = 0; i < 100; i++) expected = expected * 31 + i;
+
+    bool small = still_larger(5);
+    bool max = still_larger(INT_MAX);  // INT_MAX + 1 wraps to INT_MIN
+    int h = hash(100);
+    int w = wrapped_index(65536, 65536, 3);  // 65536 * 65536 wraps to 0
+
+    if (small && !max && h == (int)expected && w == 42)
+      std::cout << "PASSED Result: " << h << std::endl;
+    else
+      std::cout << "FAILED Result: " << small << " " << max << " " << h << " " << w << std::endl;
+}
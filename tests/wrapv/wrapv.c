@@ -0,0 +1,25 @@
+// MiniC program relying on signed overflow wrapping around,
+// compiled with the options in flags (-fwrapv --index-width=64 -O2)
+
+bool still_larger(int i) {
+  return i + 1 > i;
+}
+
+int hash(int n) {
+  int h;
+  int i;
+  h = 7;
+  i = 0;
+  while (i < n) {
+    h = h * 31 + i;
+    i = i + 1;
+  }
+  return h;
+}
+
+int wrapped_index(int i, int cols, int j) {
+  int a[10];
+  fill(a, 7);
+  a[3] = 42;
+  return a[i * cols + j];
+}
@@ -0,0 +1,38 @@
+#include <iostream>
+#include <cstdio>
+
+// clang++ driver.cpp output.ll -o zero_init
+
+
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
+
+extern "C" DLLEXPORT int print_int(int X) {
+  fprintf(stderr, "%d\n", X);
+  return 0;
+}
+
+extern "C" DLLEXPORT float print_float(float X) {
+  fprintf(stderr, "%f\n", X);
+  return 0;
+}
+
+extern "C" {
+    float loop_locals(int n);
+    int branches(int n);
+    int filled();
+}
+
+int main() {
+    float l = loop_locals(6);  // 3 + 4 + 6 + 9 + 12 + 13
+    int b = branches(0) + branches(5);
+    int f = filled();
+
+    if (l == 47.0f && b == 6 && f == 18)
+      std::cout << "PASSED Result: " << l << std::endl;
+    else
+      std::cout << "FAILED Result: " << l << " " << b << " " << f << std::endl;
+}
@@ -0,0 +1,41 @@
+// MiniC program relying on locals starting at zero, including ones declared
+// in a loop body, which start at zero again on every iteration
+
+float loop_locals(int n) {
+  int i;
+  float total;
+  i = 0;
+  while (i < n) {
+    int x;
+    int seen;
+    int hist[4];
+    float4 v;
+    x = i * 2;
+    if (i > 2) {
+      seen = seen + 1;
+    }
+    hist[i % 4] = hist[i % 4] + 1;
+    v[1] = 2.0;
+    total = total + x + seen + hist[0] + hsum(v);
+    i = i + 1;
+  }
+  return total;
+}
+
+int branches(int n) {
+  int a;
+  int b;
+  if (n > 0) {
+    a = 1;
+    b = 2;
+  } else {
+    a = 3;
+  }
+  return a + b;
+}
+
+int filled() {
+  int local[8];
+  fill(local, 2);
+  return sum(local, 8) + local[3];
+}